@@ -7,9 +7,10 @@
 #include "PsDataRoot.h"
 #include "PsNetworkData.h"
 #include "Serialize/PsDataBinarySerialization.h"
-#include "Serialize/Stream/PsDataBufferInputStream.h"
-#include "Serialize/Stream/PsDataBufferOutputStream.h"
+#include "Serialize/PsDataJournal.h"
+#include "Serialize/Stream/PsDataChunkedOutputStream.h"
 #include "Serialize/Stream/PsDataMD5OutputStream.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
 #include "Types/PsData_UPsData.h"
 
 #include "Async/Async.h"
@@ -33,6 +34,16 @@ void FPsDataFriend::AddChild(UPsData* Parent, UPsData* Data)
 	Parent->AddChild(Data);
 }
 
+void FPsDataFriend::AttachChild(UPsData* Parent, UPsData* Data)
+{
+	Parent->AttachChild(Data);
+}
+
+bool FPsDataFriend::HasChangeTracking(const UPsData* Data)
+{
+	return Data->Network != nullptr || Data->Journal != nullptr;
+}
+
 void FPsDataFriend::RemoveChild(UPsData* Parent, UPsData* Data)
 {
 	Parent->RemoveChild(Data);
@@ -43,6 +54,16 @@ void FPsDataFriend::Changed(UPsData* Data, const FDataField* Field)
 	Data->Changed(Field);
 }
 
+void FPsDataFriend::ChangedElements(UPsData* Data, const FDataField* Field, FPsDataDeltaWriter DeltaWriter)
+{
+	Data->Changed(Field, &DeltaWriter);
+}
+
+void FPsDataFriend::SetJournal(UPsData* Data, FPsDataJournal* Journal)
+{
+	Data->SetJournal(Journal);
+}
+
 void FPsDataFriend::InitProperties(UPsData* Data)
 {
 	Data->InitProperties();
@@ -99,6 +120,14 @@ void FPsDataFriend::Deserialize(UPsData* Data, FPsDataDeserializer* Deserializer
 	Data->DataDeserializeInternal(Deserializer);
 }
 
+void FPsDataFriend::PostDeserialize(UPsData* Data)
+{
+	if (Data->bChanged)
+	{
+		Data->PostDeserialize();
+	}
+}
+
 const FPsDataImprint& FPsDataFriend::GetImprint(const UPsData* Data)
 {
 	Data->CalculateImprint();
@@ -191,9 +220,9 @@ UPsData::UPsData(const class FObjectInitializer& ObjectInitializer)
 	, Parent(nullptr)
 	, Root(nullptr)
 	, Network(nullptr)
+	, Journal(nullptr)
 	, BroadcastInProgress(0)
 	, bChanged(false)
-	, SerializeBufferSize(1024)
 	, ClassFields(nullptr)
 {
 	if (HasAnyFlags(RF_ClassDefaultObject | RF_DefaultSubObject))
@@ -243,6 +272,11 @@ void UPsData::AddChild(UPsData* Child)
 	Children.Add(Child);
 	Child->AddToRootData();
 
+	if (Journal)
+	{
+		Child->SetJournal(Journal);
+	}
+
 	Child->DropImprint();
 
 	if (Child->IsBound(UPsDataEvent::AddedToParent, false))
@@ -265,6 +299,29 @@ void UPsData::AddChild(UPsData* Child)
 	{
 		Network->CommitAddedEvent(Child);
 	}
+
+	if (Journal)
+	{
+		Journal->CommitAddedEvent(Child);
+	}
+}
+
+void UPsData::AttachChild(UPsData* Child)
+{
+	if (Child->Parent)
+	{
+		UE_LOG(LogData, Fatal, TEXT("Child already added"));
+		return;
+	}
+
+	Child->Parent = this;
+	Children.Add(Child);
+	Child->AddToRootData(false);
+
+	if (Journal)
+	{
+		Child->SetJournal(Journal);
+	}
 }
 
 void UPsData::RemoveChild(UPsData* Child)
@@ -280,12 +337,22 @@ void UPsData::RemoveChild(UPsData* Child)
 		Network->CommitRemovingEvent(Child);
 	}
 
+	if (Journal)
+	{
+		Journal->CommitRemovingEvent(Child);
+	}
+
 	const auto bIsBound = Child->IsBound(UPsDataEvent::Removed, true);
 
 	Children.Remove(Child);
 	Child->Parent = nullptr;
 	Child->RemoveFromRootData();
 
+	if (Journal)
+	{
+		Child->SetJournal(nullptr);
+	}
+
 	Child->DropImprint();
 
 	if (Child->IsBound(UPsDataEvent::RemovedFromParent, false))
@@ -320,7 +387,7 @@ void UPsData::ChangeName(const FString& Name, const FString& CollectionName)
 	}
 }
 
-void UPsData::Changed(const FDataField* Field)
+void UPsData::Changed(const FDataField* Field, const FPsDataDeltaWriter* DeltaWriter)
 {
 	DropImprint();
 
@@ -351,11 +418,16 @@ void UPsData::Changed(const FDataField* Field)
 
 	if (Network && Network->HasAuthority())
 	{
-		Network->CommitChanges(this, Field);
+		Network->CommitChanges(this, Field, DeltaWriter);
+	}
+
+	if (Journal)
+	{
+		Journal->CommitChanges(this, Field);
 	}
 }
 
-void UPsData::AddToRootData()
+void UPsData::AddToRootData(bool bBroadcast)
 {
 	if (Parent->Root)
 	{
@@ -370,14 +442,14 @@ void UPsData::AddToRootData()
 			Network = Parent->Network;
 		}
 
-		if (IsBound(UPsDataEvent::AddedToRoot, false))
+		if (bBroadcast && IsBound(UPsDataEvent::AddedToRoot, false))
 		{
 			Broadcast(UPsDataEvent::ConstructEvent(UPsDataEvent::AddedToRoot, false));
 		}
 
 		for (UPsData* Child : Children)
 		{
-			Child->AddToRootData();
+			Child->AddToRootData(bBroadcast);
 		}
 	}
 }
@@ -401,6 +473,15 @@ void UPsData::RemoveFromRootData()
 	}
 }
 
+void UPsData::SetJournal(FPsDataJournal* InJournal)
+{
+	Journal = InJournal;
+	for (UPsData* Child : Children)
+	{
+		Child->SetJournal(InJournal);
+	}
+}
+
 void UPsData::DropImprint() const
 {
 	Imprint.Reset();
@@ -802,15 +883,16 @@ void UPsData::DataSerialize(FPsDataSerializer* Serializer) const
 
 void UPsData::DataSerializeAsync(FPsDataSerializer* Serializer, FPsDataAsyncSerializeDelegate CallbackDelegate) const
 {
-	auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
-	OutputStream->Reserve(SerializeBufferSize * 2);
-
+	auto OutputStream = MakeShared<FPsDataChunkedOutputStream>();
 	const auto StartOffset = FPsDataImprintBinarySerializer::Concatenate(OutputStream, this);
-	SerializeBufferSize = FMath::Max(SerializeBufferSize, OutputStream->Size());
+
+	// Imprints can be dropped while the task is running, so the stream is gathered here
+	auto Buffer = MakeShared<TArray<uint8>>();
+	OutputStream->CopyTo(Buffer.Get());
 
 	auto WeakThis = MakeWeakObjectPtr(this);
-	AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [WeakThis, OutputStream, StartOffset, Serializer, CallbackDelegate]() {
-		const auto InputStream = MakeShared<FPsDataBufferInputStream>(OutputStream->GetBuffer());
+	AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [WeakThis, Buffer, StartOffset, Serializer, CallbackDelegate]() {
+		const auto InputStream = MakeShared<FPsDataViewInputStream>(Buffer.Get());
 		FPsDataImprintBinaryDeserializer ImprintDeserializer(InputStream, StartOffset);
 		FPsDataImprintBinaryConvertor Convertor(&ImprintDeserializer);
 		Convertor.Convert(Serializer);
@@ -823,13 +905,16 @@ void UPsData::DataSerializeAsync(FPsDataSerializer* Serializer, FPsDataAsyncSeri
 	});
 }
 
-void UPsData::DataDeserialize(FPsDataDeserializer* Deserializer, bool bPatch)
+void UPsData::DataDeserialize(FPsDataDeserializer* Deserializer, bool bPatch, bool bParallelCollections)
 {
 	if (!bPatch)
 	{
 		Reset();
 	}
 
+	TGuardValue<bool> PatchGuard(Deserializer->bPatch, bPatch);
+	TGuardValue<bool> ParallelCollectionsGuard(Deserializer->bParallelCollections, bParallelCollections);
+
 	auto This = this;
 	Deserializer->ReadValue(This, {});
 	check(This);
@@ -969,14 +1054,14 @@ void UPsData::Reset()
 
 UPsData* UPsData::Copy() const
 {
-	auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
-	OutputStream->Reserve(SerializeBufferSize * 2);
-
+	auto OutputStream = MakeShared<FPsDataChunkedOutputStream>();
 	const auto StartOffset = FPsDataImprintBinarySerializer::Concatenate(OutputStream, this);
-	SerializeBufferSize = FMath::Max(SerializeBufferSize, OutputStream->Size());
+
+	TArray<uint8> Buffer;
+	OutputStream->CopyTo(Buffer);
 
 	UPsData* Copy = NewObject<UPsData>(GetTransientPackage(), GetClass());
-	FPsDataImprintBinaryDeserializer Deserializer(MakeShared<FPsDataBufferInputStream>(OutputStream->GetBuffer()), StartOffset);
+	FPsDataImprintBinaryDeserializer Deserializer(MakeShared<FPsDataViewInputStream>(Buffer), StartOffset);
 	Copy->DataDeserialize(&Deserializer);
 	return Copy;
 }
@@ -11,12 +11,22 @@ int32 FPsDataEventScopeGuard::Index = 0;
 TArray<FPsDataEventScopeGuardCallback> FPsDataEventScopeGuard::Callbacks;
 
 FPsDataEventScopeGuard::FPsDataEventScopeGuard()
+	: bActive(IsInGameThread())
 {
-	++Index;
+	// Data filled by worker threads isn't attached yet, events are held back by the game thread guard only
+	if (bActive)
+	{
+		++Index;
+	}
 }
 
 FPsDataEventScopeGuard::~FPsDataEventScopeGuard()
 {
+	if (!bActive)
+	{
+		return;
+	}
+
 	--Index;
 	check(Index >= 0);
 
@@ -20,6 +20,8 @@ const FDataStringViewChar FDataMetaType::Deprecated = "deprecated";
 const FDataStringViewChar FDataMetaType::Nullable = "nullable";
 const FDataStringViewChar FDataMetaType::Hidden = "hidden";
 const FDataStringViewChar FDataMetaType::CustomType = "customtype";
+const FDataStringViewChar FDataMetaType::Lazy = "lazy";
+const FDataStringViewChar FDataMetaType::NetPriority = "netpriority";
 
 /***********************************
  * FDataRawMeta
@@ -109,6 +111,8 @@ FDataFieldMeta::FDataFieldMeta()
 	, bDefault(true)
 	, bHidden(false)
 	, bCustomType(false)
+	, bLazy(false)
+	, NetPriority(0)
 {
 }
 
@@ -369,6 +373,29 @@ void ApplyMetaItems(FDataField* Field, FDataRawMeta& RawMeta)
 
 		RawMeta.Remove(FDataMetaType::Hidden);
 	}
+	if (const auto Lazy = RawMeta.Find(FDataMetaType::Lazy))
+	{
+		Field->Meta.bLazy = true;
+		PrintUnusedMetaValue(Lazy);
+		PrintApplyMeta(Lazy);
+
+		RawMeta.Remove(FDataMetaType::Lazy);
+	}
+	if (const auto NetPriority = RawMeta.Find(FDataMetaType::NetPriority))
+	{
+		if (const auto Value = Numbers::ToInteger<int32>(NetPriority->Value))
+		{
+			Field->Meta.NetPriority = Value.GetValue();
+		}
+		else if (!NetPriority->Value.IsEmpty())
+		{
+			UE_LOG(LogDataReflection, Error, TEXT("      ? invalid value \"%s\" for meta: \"%s\""), *ToString(NetPriority->Value), *ToString(NetPriority->Key));
+		}
+		PrintMissingMetaValue(NetPriority);
+		PrintApplyMeta(NetPriority);
+
+		RawMeta.Remove(FDataMetaType::NetPriority);
+	}
 
 	if (Field->Meta.bStrict && Field->Meta.bEvent)
 	{
@@ -376,6 +403,12 @@ void ApplyMetaItems(FDataField* Field, FDataRawMeta& RawMeta)
 		Field->Meta.bBubbles = false;
 		UE_LOG(LogDataReflection, Error, TEXT("Property with strict meta can't broadcast event"))
 	}
+
+	if (Field->Meta.bStrict && Field->Meta.bLazy)
+	{
+		Field->Meta.bLazy = false;
+		UE_LOG(LogDataReflection, Error, TEXT("Property with strict meta can't be lazy"))
+	}
 }
 
 void ApplyMetaItems(FDataLink* Link, FDataRawMeta& RawMeta)
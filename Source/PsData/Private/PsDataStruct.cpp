@@ -236,10 +236,15 @@ UPsDataStruct* UPsDataStruct::Create(UClass* PsDataClass, UPsData* DefaultData)
 
 	NewStruct->StructFlags = static_cast<EStructFlags>(NewStruct->StructFlags & ~STRUCT_ZeroConstructor);
 
-	FPsDataStructSerializer Serializer;
+	for (TFieldIterator<FProperty> It(NewStruct); It; ++It)
+	{
+		NewStruct->PropertiesByKey.Add(It->GetName(), *It);
+	}
+
+	FPsDataStructSerializer Serializer(NewStruct, false);
 	DefaultData->DataSerialize(&Serializer);
 
-	NewStruct->Finalize(Serializer.GetRaw(NewStruct, false));
+	NewStruct->Finalize(Serializer.GetRaw());
 	return NewStruct;
 }
 
@@ -266,6 +271,16 @@ void UPsDataStruct::InitializeStruct(void* Dest, int32 ArrayDim) const
 	Super::InitializeStruct(Dest, ArrayDim);
 }
 
+FProperty* UPsDataStruct::FindPropertyByKey(const FString& Key) const
+{
+	if (const auto PropertyPtr = PropertiesByKey.Find(Key))
+	{
+		return *PropertyPtr;
+	}
+
+	return nullptr;
+}
+
 void UPsDataStruct::Finalize(uint8* DefaultStruct)
 {
 	RawStruct = DefaultStruct;
@@ -3,16 +3,126 @@
 #include "PsNetworkData.h"
 
 #include "PsDataAPI.h"
+#include "Serialize/Stream/PsDataCompressedInputStream.h"
+#include "Serialize/Stream/PsDataCompressedOutputStream.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
 
+#include "Engine/ActorChannel.h"
 #include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
 #include "Engine/NetDriver.h"
-#include "EngineUtils.h"
 #include "GameFramework/PlayerController.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 
 #include <string>
 
 using namespace PsDataTools;
 
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+/** Single data property which subtree can be compared by hash */
+bool IsResyncField(const FDataField* Field)
+{
+	return Field->Context->IsData() && !Field->Context->IsArray() && !Field->Context->IsMap() && !Field->Meta.bCustomType && !Field->Meta.bHidden;
+}
+
+const UPsData* GetResyncChild(const UPsData* Data, const FDataField* Field)
+{
+	UPsData** ChildPtr = nullptr;
+	if (GetByField<false>(const_cast<UPsData*>(Data), Field, ChildPtr))
+	{
+		return *ChildPtr;
+	}
+	return nullptr;
+}
+
+bool IsInSubtree(const UPsData* Data, const UPsData* Root)
+{
+	for (; Data; Data = Data->GetParent())
+	{
+		if (Data == Root)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IsInSubtrees(const UPsData* Data, const TArray<const UPsData*>& Roots)
+{
+	for (; Data; Data = Data->GetParent())
+	{
+		if (Roots.Contains(Data))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Size of the snapshot announced by the server, anything bigger is rejected before the buffer is allocated */
+constexpr int32 MaxSynchronizeSize = Compression::MaxUncompressedSize;
+
+/** Serialized empty data, it takes the place of an added subtree hidden from the connection */
+TArray<uint8> MakePlaceholderBuffer()
+{
+	const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
+	const auto CompressedBuffer = MakeShared<FPsDataCompressedOutputStream>(OutputBuffer);
+	FPsDataBinarySerializer Serializer(CompressedBuffer);
+	Serializer.WriteObject();
+	Serializer.PopObject();
+	CompressedBuffer->Flush();
+	return MoveTemp(OutputBuffer->GetBuffer());
+}
+
+constexpr int32 MaxResyncHashes = 4096;
+constexpr int32 MaxResyncStringLength = 1024;
+
+/** Client hashes are untrusted, every length is checked against the rest of the buffer before the read */
+bool ReadResyncString(FPsDataViewInputStream& InputStream, FString& OutString)
+{
+	if (!InputStream.CanRead(4))
+	{
+		return false;
+	}
+
+	const uint32 Len = InputStream.ReadUint32Unchecked();
+	if (Len > MaxResyncStringLength || !InputStream.CanRead(static_cast<int32>(Len)))
+	{
+		return false;
+	}
+
+	const TArrayView<const uint8> Bytes = InputStream.ReadView(static_cast<int32>(Len));
+	if (Bytes.Num() > 0)
+	{
+		const auto Converter = FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Bytes.GetData()), Bytes.Num());
+		OutString = FString(Converter.Length(), Converter.Get());
+	}
+	return true;
+}
+
+bool ReadResyncHashes(const TArray<uint8>& Buffer, TMap<FString, FString>& OutHashes)
+{
+	FPsDataViewInputStream InputStream(Buffer);
+	while (InputStream.HasData())
+	{
+		FString Path;
+		FString Hash;
+		if (OutHashes.Num() >= MaxResyncHashes || !ReadResyncString(InputStream, Path) || !ReadResyncString(InputStream, Hash))
+		{
+			return false;
+		}
+		OutHashes.Add(MoveTemp(Path), MoveTemp(Hash));
+	}
+	return true;
+}
+} // namespace PsDataTools
+
 /***********************************
  * FPsNetworkByteBuffer
  ***********************************/
@@ -79,7 +189,7 @@ FPsNetworkEvent::FPsNetworkEvent()
 {
 }
 
-FPsNetworkEvent::FPsNetworkEvent(EPsNetworkEventType InType, const FString& InPath, const TArray<uint8>& InBuffer)
+FPsNetworkEvent::FPsNetworkEvent(EPsNetworkEventType InType, const TArray<uint32>& InPath, const TArray<uint8>& InBuffer)
 	: Type(InType)
 	, Path(InPath)
 	, Data(InBuffer)
@@ -110,23 +220,16 @@ FArchive& operator<<(FArchive& Ar, FPsNetworkEvent& Value)
 {
 	Ar << Value.Type;
 
+	uint32 PathLength = Value.Path.Num();
+	Ar.SerializeIntPacked(PathLength);
 	if (Ar.IsLoading())
 	{
-		TArray<char> CharKey;
-		Ar << CharKey;
-
-		const auto Converter = FUTF8ToTCHAR(CharKey.GetData(), CharKey.Num());
-		Value.Path = FString(Converter.Length(), Converter.Get());
-	}
-	else if (Ar.IsSaving())
-	{
-		const auto Converter = FTCHARToUTF8(*Value.Path, Value.Path.Len());
-		TArray<char> CharKey(Converter.Get(), Converter.Length());
-		Ar << CharKey;
+		Value.Path.SetNumUninitialized(PathLength);
 	}
-	else
+
+	for (auto& Token : Value.Path)
 	{
-		checkNoEntry();
+		Ar.SerializeIntPacked(Token);
 	}
 
 	const bool bHasData = Value.Type != EPsNetworkEventType::Removed;
@@ -167,20 +270,34 @@ FPsNetworkEventBundle::FPsNetworkEventBundle()
 {
 }
 
-void FPsNetworkEventBundle::AddEvent(EPsNetworkEventType InType, const FString& InPath, const TArray<uint8>& InBuffer)
+void FPsNetworkEventBundle::AddEvent(EPsNetworkEventType InType, const TArray<uint32>& InPath, const TArray<uint8>& InBuffer)
 {
 	check(InType != EPsNetworkEventType::None);
 	Events.Emplace(InType, InPath, InBuffer);
+	Payload.Reset();
+}
+
+void FPsNetworkEventBundle::AddKey(const FString& InKey)
+{
+	Keys.Add(InKey);
+	Payload.Reset();
 }
 
-TArray<FPsNetworkEvent> FPsNetworkEventBundle::GetBundle() const
+const TArray<FPsNetworkEvent>& FPsNetworkEventBundle::GetBundle() const
 {
 	return Events;
 }
 
+const TArray<FString>& FPsNetworkEventBundle::GetKeys() const
+{
+	return Keys;
+}
+
 void FPsNetworkEventBundle::Reset()
 {
+	Keys.Reset();
 	Events.Reset();
+	Payload.Reset();
 }
 
 bool FPsNetworkEventBundle::HasEvents() const
@@ -188,6 +305,39 @@ bool FPsNetworkEventBundle::HasEvents() const
 	return Events.Num() > 0;
 }
 
+bool FPsNetworkEventBundle::IsEmpty() const
+{
+	return Events.Num() == 0 && Keys.Num() == 0;
+}
+
+void FPsNetworkEventBundle::Seal()
+{
+	if (!Payload.IsValid())
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Writer << Keys;
+		Writer << Events;
+		Payload = MakeShared<TArray<uint8>>(MoveTemp(Bytes));
+	}
+}
+
+int32 FPsNetworkEventBundle::GetPayloadSize()
+{
+	Seal();
+	return Payload->Num();
+}
+
+bool FPsNetworkEventBundle::LoadPayload(const TArray<uint8>& Bytes)
+{
+	FMemoryReader Reader(Bytes);
+	Reader << Keys;
+	Reader << Events;
+	Payload.Reset();
+
+	return !Reader.IsError();
+}
+
 bool FPsNetworkEventBundle::Serialize(FArchive& Ar)
 {
 	Ar << *this;
@@ -210,12 +360,44 @@ bool FPsNetworkEventBundle::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& b
 
 FArchive& operator<<(FArchive& Ar, FPsNetworkEventBundle& Value)
 {
-	return Ar << Value.Events;
+	// The bundle goes as an opaque payload, so a sealed bundle is copied into the archive without serializing the events again
+	if (Ar.IsLoading())
+	{
+		TArray<uint8> Bytes;
+		Ar << Bytes;
+
+		if (!Value.LoadPayload(Bytes))
+		{
+			Ar.SetError();
+		}
+	}
+	else
+	{
+		Value.Seal();
+		Ar << const_cast<TArray<uint8>&>(*Value.Payload);
+	}
+
+	return Ar;
 }
 
 void operator<<(FStructuredArchive::FSlot Slot, FPsNetworkEventBundle& Value)
 {
-	Slot << Value.Events;
+	// Same opaque payload as the binary archive, so both paths read each other's data
+	if (Slot.GetUnderlyingArchive().IsLoading())
+	{
+		TArray<uint8> Bytes;
+		Slot << Bytes;
+
+		if (!Value.LoadPayload(Bytes))
+		{
+			Slot.GetUnderlyingArchive().SetError();
+		}
+	}
+	else
+	{
+		Value.Seal();
+		Slot << const_cast<TArray<uint8>&>(*Value.Payload);
+	}
 }
 
 template <>
@@ -238,12 +420,33 @@ IMPLEMENT_STRUCT(PsNetworkEventBundle);
 
 ADataNetworkActor::ADataNetworkActor()
 	: State(EProxyState::Created)
+	, SynchronizeOffset(0)
+	, SynchronizeSize(INDEX_NONE)
+	, bSynchronizeResync(false)
 	, NetworkData(nullptr)
 {
 	bReplicates = true;
 	RootComponent = CreateDefaultSubobject<USceneComponent>("RootComponent");
 }
 
+void ADataNetworkActor::PostNetInit()
+{
+	Super::PostNetInit();
+	UPsNetworkData::RegisterProxy(this);
+}
+
+void ADataNetworkActor::OnRep_Owner()
+{
+	Super::OnRep_Owner();
+	UPsNetworkData::RegisterProxy(this);
+}
+
+void ADataNetworkActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UPsNetworkData::UnregisterProxy(this);
+	Super::EndPlay(EndPlayReason);
+}
+
 bool ADataNetworkActor::IsAuthority() const
 {
 	if (const auto Controller = Cast<APlayerController>(GetOwner()))
@@ -282,7 +485,7 @@ void ADataNetworkActor::Open(UPsNetworkData* InNetworkData)
 	{
 		UE_LOG(LogDataNetwork, Display, TEXT("Client proxy opened"));
 		State = EProxyState::Confirmed;
-		Server_Confirm();
+		Server_Confirm(NetworkData->CollectHashes());
 	}
 }
 
@@ -308,7 +511,37 @@ void ADataNetworkActor::Close()
 	Destroy();
 }
 
-void ADataNetworkActor::Synchronize(const FPsNetworkByteBuffer& Buffer)
+void ADataNetworkActor::RequestSynchronize()
+{
+	if (State == EProxyState::Closed || IsAuthority())
+	{
+		return;
+	}
+
+	UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy requests synchronization"));
+	State = EProxyState::Confirmed;
+	SynchronizeBuffer.Empty();
+	SynchronizeSize = INDEX_NONE;
+	SynchronizeKeys.Empty();
+
+	// The data can't be trusted anymore, so the hashes aren't sent and the server replies with the full snapshot
+	Server_Confirm(FPsNetworkByteBuffer());
+}
+
+void ADataNetworkActor::ResetSynchronize()
+{
+	check(IsAuthority());
+	State = EProxyState::Confirmed;
+
+	// Everything in flight is replaced by the new snapshot
+	SynchronizePayload.Reset();
+	SynchronizeOffset = 0;
+	QueuedBundles.Empty();
+	HiddenData.Empty();
+	ClientHashes.Reset();
+}
+
+void ADataNetworkActor::Synchronize(const TSharedRef<const TArray<uint8>>& Buffer, const TArray<FString>& Keys, bool bResync)
 {
 	if (State == EProxyState::Closed)
 	{
@@ -317,7 +550,63 @@ void ADataNetworkActor::Synchronize(const FPsNetworkByteBuffer& Buffer)
 
 	check(IsAuthority() && State == EProxyState::Confirmed);
 	State = EProxyState::Synchronized;
-	Client_Synchronize(Buffer);
+	ClientHashes.Reset();
+
+	SynchronizePayload = Buffer;
+	SynchronizeOffset = 0;
+	Client_BeginSynchronize(Buffer->Num(), Keys, bResync);
+}
+
+void ADataNetworkActor::SendSynchronizeChunks(float DeltaTime)
+{
+	// The payload is kept until the queued bundles are sent too, so the new bundles keep their order behind the snapshot
+	if (State != EProxyState::Synchronized || !SynchronizePayload.IsValid())
+	{
+		return;
+	}
+
+	const auto Connection = GetNetConnection();
+	if (!Connection)
+	{
+		return;
+	}
+
+	// The chunks of a tick are limited by the speed of the connection, at least one chunk is sent when the channel is free
+	const int32 ChunkSize = FMath::Max(NetworkData->SynchronizeChunkSize, 1);
+	const auto& Payload = *SynchronizePayload;
+	int32 Budget = FMath::Max(FMath::TruncToInt(Connection->CurrentNetSpeed * DeltaTime), ChunkSize);
+	int32 NumSentBundles = 0;
+	while ((SynchronizeOffset < Payload.Num() || NumSentBundles < QueuedBundles.Num()) && Budget > 0 && Connection->IsNetReady(false))
+	{
+		const auto Channel = Connection->FindActorChannelRef(this);
+		if (Channel && Channel->NumOutRec >= RELIABLE_BUFFER / 2)
+		{
+			break;
+		}
+
+		if (SynchronizeOffset < Payload.Num())
+		{
+			const int32 Count = FMath::Min(ChunkSize, Payload.Num() - SynchronizeOffset);
+			Client_SynchronizeChunk(FPsNetworkByteBuffer(TArray<uint8>(Payload.GetData() + SynchronizeOffset, Count)));
+			SynchronizeOffset += Count;
+			Budget -= Count;
+		}
+		else
+		{
+			// Bundles go after the last chunk in the same reliable channel, so the client applies them on top of the snapshot
+			auto& Events = QueuedBundles[NumSentBundles++];
+			Client_Send(Events);
+			Budget -= Events.GetPayloadSize();
+		}
+	}
+
+	QueuedBundles.RemoveAt(0, NumSentBundles);
+
+	if (SynchronizeOffset >= Payload.Num() && QueuedBundles.Num() == 0)
+	{
+		SynchronizePayload.Reset();
+		SynchronizeOffset = 0;
+	}
 }
 
 void ADataNetworkActor::Send(const FPsNetworkEventBundle& Events)
@@ -328,27 +617,99 @@ void ADataNetworkActor::Send(const FPsNetworkEventBundle& Events)
 	}
 
 	check(IsAuthority() && State == EProxyState::Synchronized);
+	if (SynchronizePayload.IsValid())
+	{
+		// A client that can't keep up gets the current state instead of the backlog
+		const int32 MaxQueuedBundles = NetworkData->MaxQueuedBundles;
+		if (MaxQueuedBundles > 0 && QueuedBundles.Num() >= MaxQueuedBundles)
+		{
+			UE_LOG(LogDataNetwork, Warning, TEXT("Server proxy has %d bundles queued behind the snapshot, the client is resynchronized"), QueuedBundles.Num());
+			ResetSynchronize();
+			NetworkData->FlushRequest();
+			return;
+		}
+
+		QueuedBundles.Add(Events);
+		return;
+	}
+
 	Client_Send(Events);
 }
 
-void ADataNetworkActor::Server_Confirm_Implementation()
+void ADataNetworkActor::Server_Confirm_Implementation(const FPsNetworkByteBuffer& Hashes)
 {
 	check(IsAuthority());
 	UE_LOG(LogDataNetwork, Display, TEXT("Server proxy confirmed"));
-	State = EProxyState::Confirmed;
+
+	// The client may ask for the snapshot again
+	ResetSynchronize();
+
+	if (!ReadResyncHashes(Hashes.Buffer, ClientHashes))
+	{
+		UE_LOG(LogDataNetwork, Warning, TEXT("Malformed hashes (%d bytes) from the client, the full snapshot will be sent"), Hashes.Buffer.Num());
+		ClientHashes.Reset();
+	}
+
 	NetworkData->FlushRequest();
 	NetworkData->SynchronizePromise.Resolve();
 }
 
-void ADataNetworkActor::Client_Synchronize_Implementation(const FPsNetworkByteBuffer& Buffer)
+void ADataNetworkActor::Client_BeginSynchronize_Implementation(int32 Size, const TArray<FString>& Keys, bool bResync)
+{
+	if (Size < 0 || Size > MaxSynchronizeSize)
+	{
+		UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy rejected the snapshot of %d bytes"), Size);
+		RequestSynchronize();
+		return;
+	}
+
+	SynchronizeBuffer.Reset(Size);
+	SynchronizeSize = Size;
+	SynchronizeKeys = Keys;
+	bSynchronizeResync = bResync;
+}
+
+void ADataNetworkActor::Client_SynchronizeChunk_Implementation(const FPsNetworkByteBuffer& Chunk)
 {
+	// Chunks of a rejected or replaced snapshot
+	if (SynchronizeSize == INDEX_NONE)
+	{
+		return;
+	}
+
+	SynchronizeBuffer.Append(Chunk.Buffer);
+	if (SynchronizeBuffer.Num() < SynchronizeSize)
+	{
+		return;
+	}
+
+	if (SynchronizeBuffer.Num() != SynchronizeSize)
+	{
+		UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy received %d bytes of the snapshot of %d bytes"), SynchronizeBuffer.Num(), SynchronizeSize);
+		RequestSynchronize();
+		return;
+	}
+
 	State = EProxyState::Synchronized;
-	NetworkData->Synchronize(Buffer);
+
+	// The transfer is finished before applying, a failed snapshot requests the next one
+	const FPsNetworkByteBuffer Buffer(SynchronizeBuffer);
+	const TArray<FString> Keys = MoveTemp(SynchronizeKeys);
+	SynchronizeBuffer.Empty();
+	SynchronizeSize = INDEX_NONE;
+	SynchronizeKeys.Empty();
+	NetworkData->Synchronize(Buffer, Keys, bSynchronizeResync);
 }
 
 void ADataNetworkActor::Client_Send_Implementation(const FPsNetworkEventBundle& Events)
 {
-	check(State == EProxyState::Synchronized);
+	// Bundles sent before the server got the synchronization request are covered by the next snapshot
+	if (State != EProxyState::Synchronized)
+	{
+		UE_LOG(LogDataNetwork, Verbose, TEXT("Client proxy dropped the events received before the snapshot"));
+		return;
+	}
+
 	NetworkData->Apply(Events);
 }
 
@@ -356,11 +717,21 @@ void ADataNetworkActor::Client_Send_Implementation(const FPsNetworkEventBundle&
  * UPsNetworkData
  ***********************************/
 
+TMap<TWeakObjectPtr<const APlayerController>, TWeakObjectPtr<ADataNetworkActor>> UPsNetworkData::RegisteredProxies;
+TMap<TWeakObjectPtr<const APlayerController>, TWeakObjectPtr<UPsNetworkData>> UPsNetworkData::PendingNetworks;
+
 UPsNetworkData::UPsNetworkData()
 	: NetUpdateFrequency(30.f)
+	, NetBudget(0)
+	, SynchronizeBudget(0)
+	, SynchronizeChunkSize(16 * 1024)
+	, ResyncDepth(0)
+	, MaxPathKeys(64 * 1024)
+	, MaxQueuedBundles(1024)
 	, AccumulatedTime(0.f)
 	, NumAuthorityProxies(0)
 	, bForceFlush(false)
+	, NumSentPathKeys(0)
 {
 }
 
@@ -399,7 +770,18 @@ void UPsNetworkData::OpenConnection(APlayerController* Controller) const
 	else
 	{
 		MutableReset();
-		PendingControllers.Add(Controller);
+
+		// The proxy may be replicated before the connection is opened
+		TWeakObjectPtr<ADataNetworkActor> Proxy;
+		if (RegisteredProxies.RemoveAndCopyValue(Controller, Proxy) && Proxy.IsValid())
+		{
+			OpenProxy(Controller, Proxy.Get());
+		}
+		else
+		{
+			PendingControllers.Add(Controller);
+			PendingNetworks.Add(Controller, const_cast<UPsNetworkData*>(this));
+		}
 	}
 }
 
@@ -431,6 +813,7 @@ void UPsNetworkData::CloseConnection(APlayerController* Controller) const
 		const auto PendingController = *It;
 		if (PendingController == Controller)
 		{
+			PendingNetworks.Remove(Controller);
 			It.RemoveCurrent();
 			return;
 		}
@@ -451,9 +834,20 @@ void UPsNetworkData::FlushRequest() const
 
 void UPsNetworkData::Flush()
 {
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_PsNetworkData_Flush);
+
 	bForceFlush = false;
+	BuildNetworkEvents();
+
 	if (HasAuthority())
 	{
+		// Key ids are held by the synchronized clients, so a too big dictionary is dropped together with their data
+		const bool bResetPathKeys = MaxPathKeys > 0 && PathKeys.Num() > MaxPathKeys;
+		if (bResetPathKeys)
+		{
+			UE_LOG(LogDataNetwork, Display, TEXT("Network data has %d path keys, clients are resynchronized"), PathKeys.Num());
+		}
+
 		TArray<ADataNetworkActor*> ConfirmedProxies;
 		TArray<ADataNetworkActor*> SynchronizedProxies;
 
@@ -461,47 +855,74 @@ void UPsNetworkData::Flush()
 		{
 			if (NetworkProxy->IsAuthority())
 			{
+				if (bResetPathKeys && NetworkProxy->IsSynchronized())
+				{
+					NetworkProxy->ResetSynchronize();
+				}
+
 				if (NetworkProxy->IsConfirmed())
 				{
 					ConfirmedProxies.Add(NetworkProxy);
 				}
 
-				if (NetworkEvents.HasEvents())
+				if (NetworkProxy->IsSynchronized())
 				{
-					if (NetworkProxy->IsSynchronized())
-					{
-						SynchronizedProxies.Add(NetworkProxy);
-					}
+					SynchronizedProxies.Add(NetworkProxy);
 				}
 			}
 		}
 
-		const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
 		if (SynchronizedProxies.Num() > 0)
 		{
-			const FPsNetworkByteBuffer Buffer(OutputBuffer->GetBuffer());
-			for (const auto NetworkObject : SynchronizedProxies)
-			{
-				NetworkObject->Send(NetworkEvents);
-			}
+			SendNetworkEvents(SynchronizedProxies);
+		}
+		else
+		{
+			// No client holds the key ids, the new snapshots start an empty dictionary
+			PathKeys.Reset();
+			PathKeyIds.Reset();
+			NumSentPathKeys = 0;
 		}
 
 		if (ConfirmedProxies.Num() > 0)
 		{
-			OutputBuffer->Reset();
-			FPsDataBinarySerializer Serializer(OutputBuffer);
-			Serializer.bWriteDefaults = false;
-			DataSerialize(&Serializer);
-
-			const FPsNetworkByteBuffer Buffer(OutputBuffer->GetBuffer());
+			// Clients that reported their hashes get the changed subtrees only, the full snapshot is serialized once for the rest
+			TSharedPtr<const TArray<uint8>> Snapshot;
 			for (const auto NetworkObject : ConfirmedProxies)
 			{
-				NetworkObject->Synchronize(Buffer);
+				if (NetworkObject->ClientHashes.Num() > 0)
+				{
+					NetworkObject->Synchronize(SerializeResync(NetworkObject->ClientHashes), PathKeys, true);
+					continue;
+				}
+
+				if (!Snapshot.IsValid())
+				{
+					const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
+					const auto CompressedBuffer = MakeShared<FPsDataCompressedOutputStream>(OutputBuffer);
+					FPsDataBinarySerializer Serializer(CompressedBuffer);
+					Serializer.bWriteDefaults = false;
+					DataSerialize(&Serializer);
+					CompressedBuffer->Flush();
+
+					Snapshot = MakeShared<TArray<uint8>>(MoveTemp(OutputBuffer->GetBuffer()));
+				}
+
+				NetworkObject->Synchronize(Snapshot.ToSharedRef(), PathKeys, false);
+			}
+
+			// Deferred element operations are already in the snapshot, the whole values apply to both the old and the new clients
+			for (auto& Pair : PendingChanges)
+			{
+				Pair.Value.bFullValue = true;
+				Pair.Value.Delta.Reset();
 			}
 		}
 	}
 
 	NetworkEvents.Reset();
+	NetworkEventOwners.Reset();
+	NetworkEventAddedData.Reset();
 }
 
 FPsDataSimplePromise& UPsNetworkData::OnSynchronizePromise() const
@@ -525,6 +946,14 @@ void UPsNetworkData::Tick(float DeltaTime)
 			Flush();
 			AccumulatedTime = 0.f;
 		}
+
+		for (const auto NetworkProxy : NetworkProxies)
+		{
+			if (NetworkProxy->IsAuthority())
+			{
+				NetworkProxy->SendSynchronizeChunks(DeltaTime);
+			}
+		}
 	}
 
 	HandlingControllers();
@@ -535,73 +964,655 @@ TStatId UPsNetworkData::GetStatId() const
 	RETURN_QUICK_DECLARE_CYCLE_STAT(UPsNetworkData, STATGROUP_Tickables);
 }
 
-void UPsNetworkData::CommitChanges(const UPsData* Data, const FDataField* Field)
+void UPsNetworkData::CommitChanges(const UPsData* Data, const FDataField* Field, const FPsDataDeltaWriter* DeltaWriter)
 {
 	if (!Field->Context->IsData())
 	{
-		const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
-		FPsDataBinarySerializer Serializer(OutputBuffer);
-		Serializer.bWriteDefaults = false;
-		const auto Property = FPsDataFriend::GetProperty(Data, Field->Index);
-		Property->Serialize(&Serializer);
+		const auto Key = MakeTuple(Data, Field);
+		auto Change = PendingChanges.Find(Key);
+		if (!Change)
+		{
+			Change = &PendingChanges.Add(Key, {Data, {}, false, 0});
+		}
 
-		FString Path = Data->GetPathFromData(this);
-		Path.AppendChar('.');
-		Path.Append(Field->Name);
+		// Element operations are collected until they outgrow the container, then the whole value is sent
+		if (!Change->bFullValue)
+		{
+			if (DeltaWriter)
+			{
+				(*DeltaWriter)(Change->Delta);
+			}
 
-		NetworkEvents.AddEvent(EPsNetworkEventType::Changed, Path, OutputBuffer->GetBuffer());
+			if (!DeltaWriter || !Change->Delta.IsCompact())
+			{
+				Change->bFullValue = true;
+				Change->Delta.Reset();
+			}
+		}
 	}
 }
 
 void UPsNetworkData::CommitAddedEvent(const UPsData* Data)
 {
 	const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
-	FPsDataBinarySerializer Serializer(OutputBuffer);
+	const auto CompressedBuffer = MakeShared<FPsDataCompressedOutputStream>(OutputBuffer);
+	FPsDataBinarySerializer Serializer(CompressedBuffer);
 	Serializer.bWriteDefaults = false;
 	Data->DataSerialize(&Serializer);
+	CompressedBuffer->Flush();
 
-	NetworkEvents.AddEvent(EPsNetworkEventType::Added, Data->GetPathFromData(this), OutputBuffer->GetBuffer());
-}
+	TArray<uint32> Path;
+	EncodePath(Data, Path);
 
-void UPsNetworkData::CommitRemovingEvent(const UPsData* Data)
-{
-	NetworkEvents.AddEvent(EPsNetworkEventType::Removed, Data->GetPathFromData(this), {});
+	PendingEvents.Add({EPsNetworkEventType::Added, MoveTemp(Path), MoveTemp(OutputBuffer->GetBuffer()), Data, Data->GetParent()});
 }
 
-void UPsNetworkData::HandlingControllers()
+void UPsNetworkData::CommitRemovingEvent(const UPsData* Data)
 {
-	if (PendingControllers.Num() > 0)
+	// Changes of the removed subtree aren't needed anymore
+	for (auto It = PendingChanges.CreateIterator(); It; ++It)
 	{
-		for (auto ControllerIterator = PendingControllers.CreateIterator(); ControllerIterator; ++ControllerIterator)
+		for (const UPsData* Parent = It.Key().Key; Parent; Parent = Parent->GetParent())
 		{
-			const auto PendingController = *ControllerIterator;
-			if (PendingController == nullptr)
-			{
-				ControllerIterator.RemoveCurrent();
-			}
-			else
+			if (Parent == Data)
 			{
-				for (TActorIterator<ADataNetworkActor> ActorIterator(PendingController->GetWorld()); ActorIterator; ++ActorIterator)
-				{
-					const auto PendingActor = *ActorIterator;
-					if (PendingActor->GetOwner() == PendingController)
-					{
-						ControllerIterator.RemoveCurrent();
-						PendingActor->Open(this);
-						NetworkProxies.Add(PendingActor);
-					}
-				}
+				It.RemoveCurrent();
+				break;
 			}
 		}
 	}
+
+	if (!CancelAddedEvent(Data))
+	{
+		TArray<uint32> Path;
+		EncodePath(Data, Path);
+
+		PendingEvents.Add({EPsNetworkEventType::Removed, MoveTemp(Path), {}, Data, Data->GetParent()});
+	}
 }
 
-void UPsNetworkData::Synchronize(const FPsNetworkByteBuffer& Buffer)
+bool UPsNetworkData::CancelAddedEvent(const UPsData* Data)
 {
-	check(!HasAuthority());
+	// Only the last event can be cancelled: paths of the later events (like indices of an array) may depend on it
+	if (PendingEvents.Num() > 0)
+	{
+		const auto& LastEvent = PendingEvents.Last();
+		if (LastEvent.Type == EPsNetworkEventType::Added && LastEvent.Data == Data)
+		{
+			PendingEvents.Pop(false);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UPsNetworkData::BuildNetworkEvents()
+{
+	NetworkEvents.Reset();
+	NetworkEventOwners.Reset();
+	NetworkEventAddedData.Reset();
+
+	for (auto& Event : PendingEvents)
+	{
+		NetworkEvents.AddEvent(Event.Type, Event.Path, Event.Buffer);
+		NetworkEventOwners.Add(Event.Owner);
+		NetworkEventAddedData.Add(Event.Type == EPsNetworkEventType::Added ? Event.Data : nullptr);
+	}
+
+	TArray<TPair<const UPsData*, const FDataField*>> ChangeKeys;
+	PendingChanges.GenerateKeyArray(ChangeKeys);
+
+	// Changes over the budget stay pending, the age keeps the low priority changes from starving
+	if (NetBudget > 0)
+	{
+		ChangeKeys.StableSort([this](const TPair<const UPsData*, const FDataField*>& A, const TPair<const UPsData*, const FDataField*>& B) {
+			return A.Value->Meta.NetPriority + PendingChanges[A].Age > B.Value->Meta.NetPriority + PendingChanges[B].Age;
+		});
+	}
+
+	// Changes are applied after the added and removed events, so the paths and the values are taken from the current state
+	int32 ChangesSize = 0;
+	for (const auto& ChangeKey : ChangeKeys)
+	{
+		const auto& Change = PendingChanges[ChangeKey];
+		const UPsData* Data = Change.Data.Get();
+		if (!Data)
+		{
+			PendingChanges.Remove(ChangeKey);
+			continue;
+		}
+
+		const auto Field = ChangeKey.Value;
+		const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
+		const auto CompressedBuffer = MakeShared<FPsDataCompressedOutputStream>(OutputBuffer);
+		if (Change.bFullValue)
+		{
+			FPsDataBinarySerializer Serializer(CompressedBuffer);
+			Serializer.bWriteDefaults = false;
+			const auto Property = FPsDataFriend::GetProperty(Data, Field->Index);
+			Property->Serialize(&Serializer);
+		}
+		else
+		{
+			CompressedBuffer->WriteUint32(Change.Delta.NumOperations);
+			CompressedBuffer->WriteBuffer(Change.Delta.Bytes);
+		}
+		CompressedBuffer->Flush();
+
+		// At least one change is sent per flush, so a change bigger than the budget isn't deferred forever
+		if (NetBudget > 0 && ChangesSize > 0 && ChangesSize + OutputBuffer->Size() > NetBudget)
+		{
+			break;
+		}
+		ChangesSize += OutputBuffer->Size();
+
+		TArray<uint32> Path;
+		EncodePath(Data, Path);
+		Path.Add(Field->Index);
+
+		NetworkEvents.AddEvent(Change.bFullValue ? EPsNetworkEventType::Changed : EPsNetworkEventType::ChangedElements, Path, OutputBuffer->GetBuffer());
+		NetworkEventOwners.Add(Change.Data);
+		NetworkEventAddedData.Add(nullptr);
+		PendingChanges.Remove(ChangeKey);
+	}
+
+	for (auto& Pair : PendingChanges)
+	{
+		++Pair.Value.Age;
+	}
+
+	// Keys are added after the changes are encoded, the client registers them before applying the events
+	for (; NumSentPathKeys < PathKeys.Num(); ++NumSentPathKeys)
+	{
+		NetworkEvents.AddKey(PathKeys[NumSentPathKeys]);
+	}
+
+	PendingEvents.Reset();
+}
+
+void UPsNetworkData::SendNetworkEvents(const TArray<ADataNetworkActor*>& Proxies)
+{
+	if (!RelevancyDelegate.IsBound())
+	{
+		if (!NetworkEvents.IsEmpty())
+		{
+			// The RPCs of all proxies copy the same payload instead of serializing the events per connection
+			NetworkEvents.Seal();
+			for (const auto NetworkObject : Proxies)
+			{
+				NetworkObject->Send(NetworkEvents);
+			}
+		}
+		return;
+	}
+
+	// Events of the subtrees hidden from a connection are dropped, a hidden subtree is sent whole once it becomes relevant
+	const auto& Events = NetworkEvents.GetBundle();
+	TArray<TBitArray<>> Filters;
+	TArray<TBitArray<>> Placeholders;
+	TArray<TArray<FPsNetworkPendingEvent>> Resyncs;
+
+	for (const auto NetworkObject : Proxies)
+	{
+		const auto Controller = Cast<APlayerController>(NetworkObject->GetOwner());
+		TMap<const UPsData*, const UPsData*> HiddenCache;
+
+		TArray<const UPsData*> RelevantData;
+		TArray<const UPsData*> HiddenAncestors;
+		for (auto It = NetworkObject->HiddenData.CreateIterator(); It; ++It)
+		{
+			const UPsData* Data = It->Get();
+			if (!Data || !IsInSubtree(Data, this))
+			{
+				It.RemoveCurrent();
+				continue;
+			}
+
+			const UPsData* Hidden = FindHiddenData(Data, Controller, HiddenCache);
+			if (!Hidden)
+			{
+				RelevantData.Add(Data);
+				It.RemoveCurrent();
+			}
+			else if (Hidden != Data)
+			{
+				HiddenAncestors.Add(Hidden);
+			}
+		}
+
+		for (const auto Data : HiddenAncestors)
+		{
+			NetworkObject->HiddenData.Add(Data);
+		}
+
+		const auto RelevantRoots = RelevantData;
+		RelevantData.RemoveAll([&RelevantRoots](const UPsData* Data) {
+			return IsInSubtrees(Data->GetParent(), RelevantRoots);
+		});
+
+		auto& Filter = Filters.Emplace_GetRef(true, Events.Num());
+		auto& Placeholder = Placeholders.Emplace_GetRef(false, Events.Num());
+		for (int32 i = 0; i < Events.Num(); ++i)
+		{
+			const UPsData* Owner = NetworkEventOwners[i].Get();
+			if (!Owner)
+			{
+				continue;
+			}
+
+			if (IsInSubtrees(Owner, RelevantData))
+			{
+				Filter[i] = false;
+			}
+			else if (const UPsData* Hidden = FindHiddenData(Owner, Controller, HiddenCache))
+			{
+				Filter[i] = false;
+				NetworkObject->HiddenData.Add(Hidden);
+			}
+			else if (const UPsData* AddedData = NetworkEventAddedData[i].Get())
+			{
+				// Hidden added data goes as an empty placeholder, so the paths of the next events (array indices) stay the same
+				if (const UPsData* HiddenAdded = FindHiddenData(AddedData, Controller, HiddenCache))
+				{
+					Filter[i] = false;
+					Placeholder[i] = true;
+					NetworkObject->HiddenData.Add(HiddenAdded);
+				}
+			}
+		}
+
+		// Properties of the relevant subtree are sent with defaults, so they overwrite the stale values of the client
+		auto& Resync = Resyncs.AddDefaulted_GetRef();
+		for (const auto Data : RelevantData)
+		{
+			TArray<uint32> DataPath;
+			EncodePath(Data, DataPath);
+
+			for (const auto Property : FPsDataFriend::GetProperties(const_cast<UPsData*>(Data)))
+			{
+				const auto Field = Property->GetField();
+				if (Field->Meta.bHidden)
+				{
+					continue;
+				}
+
+				const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
+				const auto CompressedBuffer = MakeShared<FPsDataCompressedOutputStream>(OutputBuffer);
+				FPsDataBinarySerializer Serializer(CompressedBuffer);
+				Serializer.bWriteDefaults = true;
+				Property->Serialize(&Serializer);
+				CompressedBuffer->Flush();
+
+				TArray<uint32> Path = DataPath;
+				Path.Add(Field->Index);
+				Resync.Add({EPsNetworkEventType::Changed, MoveTemp(Path), MoveTemp(OutputBuffer->GetBuffer()), Data, Data});
+			}
+		}
+	}
+
+	// Paths of the sent subtrees may add map keys, all connections get them to keep the ids in sync
+	for (; NumSentPathKeys < PathKeys.Num(); ++NumSentPathKeys)
+	{
+		NetworkEvents.AddKey(PathKeys[NumSentPathKeys]);
+	}
+
+	TArray<uint8> PlaceholderBuffer;
+	for (int32 ProxyIndex = 0; ProxyIndex < Proxies.Num(); ++ProxyIndex)
+	{
+		const auto& Filter = Filters[ProxyIndex];
+		const auto& Placeholder = Placeholders[ProxyIndex];
+		const auto& Resync = Resyncs[ProxyIndex];
+		if (Resync.Num() == 0 && Filter.Find(false) == INDEX_NONE)
+		{
+			if (!NetworkEvents.IsEmpty())
+			{
+				NetworkEvents.Seal();
+				Proxies[ProxyIndex]->Send(NetworkEvents);
+			}
+			continue;
+		}
+
+		FPsNetworkEventBundle ProxyEvents;
+		for (const auto& Key : NetworkEvents.GetKeys())
+		{
+			ProxyEvents.AddKey(Key);
+		}
+
+		for (int32 i = 0; i < Events.Num(); ++i)
+		{
+			const auto& Event = Events[i];
+			if (Filter[i])
+			{
+				ProxyEvents.AddEvent(Event.Type, Event.Path, Event.Data.Buffer);
+			}
+			else if (Placeholder[i])
+			{
+				if (PlaceholderBuffer.Num() == 0)
+				{
+					PlaceholderBuffer = MakePlaceholderBuffer();
+				}
+				ProxyEvents.AddEvent(Event.Type, Event.Path, PlaceholderBuffer);
+			}
+		}
+
+		// The subtrees go after the other events, their paths are taken from the current state
+		for (const auto& Event : Resync)
+		{
+			ProxyEvents.AddEvent(Event.Type, Event.Path, Event.Buffer);
+		}
+
+		if (!ProxyEvents.IsEmpty())
+		{
+			Proxies[ProxyIndex]->Send(ProxyEvents);
+		}
+	}
+}
+
+const UPsData* UPsNetworkData::FindHiddenData(const UPsData* Data, const APlayerController* Controller, TMap<const UPsData*, const UPsData*>& Cache) const
+{
+	const UPsData* Parent = Data->GetParent();
+	if (Data == this || !Parent)
+	{
+		return nullptr;
+	}
+
+	if (const auto CachedPtr = Cache.Find(Data))
+	{
+		return *CachedPtr;
+	}
+
+	const UPsData* Hidden = FindHiddenData(Parent, Controller, Cache);
+	if (!Hidden && !RelevancyDelegate.Execute(Data, Controller))
+	{
+		Hidden = Data;
+	}
+
+	Cache.Add(Data, Hidden);
+	return Hidden;
+}
+
+void UPsNetworkData::EncodePath(const UPsData* Data, TArray<uint32>& OutPath)
+{
+	const UPsData* Parent = Data->GetParent();
+	if (Data == this || !Parent)
+	{
+		return;
+	}
+
+	EncodePath(Parent, OutPath);
+
+	const auto& FieldName = Data->InCollection() ? Data->GetCollectionKey() : Data->GetDataKey();
+	const auto Field = FDataReflection::GetFieldsByClass(Parent->GetClass())->GetFieldByNameChecked(FieldName);
+	OutPath.Add(Field->Index);
+
+	if (Data->InCollection())
+	{
+		const auto& Key = Data->GetDataKey();
+		if (Field->Context->IsArray())
+		{
+			OutPath.Add(Numbers::ToUnsignedInteger<uint32>(ToStringView(Key)).GetValue());
+		}
+		else if (const auto IdPtr = PathKeyIds.Find(Key))
+		{
+			OutPath.Add(*IdPtr);
+		}
+		else
+		{
+			const uint32 Id = PathKeys.Add(Key);
+			PathKeyIds.Add(Key, Id);
+			OutPath.Add(Id);
+		}
+	}
+}
+
+bool UPsNetworkData::ResolvePath(const TArray<uint32>& Path, FPsNetworkPathCache& Cache, FAbstractDataProperty*& OutProperty, FString& OutKey) const
+{
+	int32 CommonLength = 0;
+	const int32 MaxLength = FMath::Min(Path.Num(), Cache.Path.Num());
+	while (CommonLength < MaxLength && Path[CommonLength] == Cache.Path[CommonLength])
+	{
+		++CommonLength;
+	}
+
+	// The walk starts from the deepest cached data on the common prefix, the cache holds only the ancestors of the last changed property,
+	// so the events of the bundle can't invalidate it
+	while (Cache.Nodes.Num() > 0 && (Cache.Nodes.Last().Key > CommonLength || Cache.Nodes.Last().Key >= Path.Num()))
+	{
+		Cache.Nodes.Pop(false);
+	}
+
+	if (Cache.Nodes.Num() == 0)
+	{
+		Cache.Nodes.Emplace(0, const_cast<UPsNetworkData*>(this));
+	}
+	Cache.Path = Path;
+
+	UPsData* Data = Cache.Nodes.Last().Value;
+	for (int32 i = Cache.Nodes.Last().Key; i < Path.Num();)
+	{
+		const auto Field = FDataReflection::GetFieldsByClass(Data->GetClass())->GetFieldByIndex(Path[i++]);
+		if (!Field)
+		{
+			return false;
+		}
+
+		OutKey.Reset();
+		if ((Field->Context->IsArray() || Field->Context->IsMap()) && i < Path.Num())
+		{
+			const uint32 Token = Path[i++];
+			if (Field->Context->IsArray())
+			{
+				OutKey = FString::FromInt(Token);
+			}
+			else if (PathKeys.IsValidIndex(Token))
+			{
+				OutKey = PathKeys[Token];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		OutProperty = FPsDataFriend::GetProperty(Data, Field->Index);
+		if (i == Path.Num())
+		{
+			return true;
+		}
+
+		UPsData** ChildPtr = nullptr;
+		const bool bFound = OutKey.IsEmpty() ? GetByField<false>(Data, Field, ChildPtr) : GetByFieldAndKey<false, false>(Data, Field, OutKey, ChildPtr);
+		if (!bFound || !*ChildPtr)
+		{
+			return false;
+		}
+
+		Data = *ChildPtr;
+		Cache.Nodes.Emplace(i, Data);
+	}
+
+	return false;
+}
+
+void UPsNetworkData::HandlingControllers()
+{
+	// Proxies are paired when they are registered, only the destroyed controllers are dropped here
+	if (PendingControllers.Num() > 0)
+	{
+		PendingControllers.Remove(nullptr);
+	}
+}
+
+void UPsNetworkData::OpenProxy(APlayerController* Controller, ADataNetworkActor* Proxy) const
+{
+	PendingControllers.Remove(Controller);
+	Proxy->Open(const_cast<UPsNetworkData*>(this));
+	NetworkProxies.Add(Proxy);
+}
+
+void UPsNetworkData::RegisterProxy(ADataNetworkActor* Proxy)
+{
+	const auto Controller = Cast<APlayerController>(Proxy->GetOwner());
+	if (!Controller || Proxy->HasAuthority() || Proxy->State != ADataNetworkActor::EProxyState::Created)
+	{
+		return;
+	}
+
+	TWeakObjectPtr<UPsNetworkData> NetworkData;
+	if (PendingNetworks.RemoveAndCopyValue(Controller, NetworkData) && NetworkData.IsValid())
+	{
+		NetworkData->OpenProxy(Controller, Proxy);
+		return;
+	}
+
+	RegisteredProxies.Add(Controller, Proxy);
+}
+
+void UPsNetworkData::UnregisterProxy(ADataNetworkActor* Proxy)
+{
+	const auto Controller = Cast<APlayerController>(Proxy->GetOwner());
+	const auto ProxyPtr = Controller ? RegisteredProxies.Find(Controller) : nullptr;
+	if (ProxyPtr && ProxyPtr->Get() == Proxy)
+	{
+		RegisteredProxies.Remove(Controller);
+	}
+}
+
+FPsNetworkByteBuffer UPsNetworkData::CollectHashes() const
+{
+	if (ResyncDepth <= 0)
+	{
+		return {};
+	}
+
+	FPsDataBufferOutputStream OutputStream;
+	CollectHashes(this, 0, OutputStream);
+	return FPsNetworkByteBuffer(OutputStream.GetBuffer());
+}
+
+void UPsNetworkData::CollectHashes(const UPsData* Data, int32 Depth, FPsDataOutputStream& OutputStream) const
+{
+	OutputStream.WriteString(Data->GetPathFromData(this));
+	OutputStream.WriteString(Data->GetHash());
+
+	if (Depth < ResyncDepth)
+	{
+		for (const auto Field : FDataReflection::GetFieldsByClass(Data->GetClass())->GetFieldsList())
+		{
+			if (IsResyncField(Field))
+			{
+				if (const auto Child = GetResyncChild(Data, Field))
+				{
+					CollectHashes(Child, Depth + 1, OutputStream);
+				}
+			}
+		}
+	}
+}
+
+TSharedRef<const TArray<uint8>> UPsNetworkData::SerializeResync(const TMap<FString, FString>& Hashes) const
+{
+	const auto OutputBuffer = MakeShared<FPsDataBufferOutputStream>();
+	const auto CompressedBuffer = MakeShared<FPsDataCompressedOutputStream>(OutputBuffer);
+	FPsDataBinarySerializer Serializer(CompressedBuffer);
+
+	// Defaults are written so the sent properties overwrite the client values completely
+	Serializer.bWriteDefaults = true;
+
+	const auto HashPtr = Hashes.Find(GetPathFromData(this));
+	if (HashPtr && *HashPtr == GetHash())
+	{
+		Serializer.WriteObject();
+		Serializer.PopObject();
+	}
+	else
+	{
+		SerializeResync(this, 0, Hashes, &Serializer);
+	}
+	CompressedBuffer->Flush();
+
+	return MakeShared<TArray<uint8>>(MoveTemp(OutputBuffer->GetBuffer()));
+}
+
+void UPsNetworkData::SerializeResync(const UPsData* Data, int32 Depth, const TMap<FString, FString>& Hashes, FPsDataSerializer* Serializer) const
+{
+	Serializer->WriteObject();
+	for (const auto Property : FPsDataFriend::GetProperties(const_cast<UPsData*>(Data)))
+	{
+		const auto Field = Property->GetField();
+		if (Field->Meta.bHidden)
+		{
+			continue;
+		}
+
+		// Subtrees the client has are skipped if the hashes match and walked down otherwise
+		const UPsData* Child = Depth < ResyncDepth && IsResyncField(Field) ? GetResyncChild(Data, Field) : nullptr;
+		const FString* HashPtr = Child ? Hashes.Find(Child->GetPathFromData(this)) : nullptr;
+		if (HashPtr && *HashPtr == Child->GetHash())
+		{
+			continue;
+		}
+
+		const auto& Key = Field->GetNameForSerialize();
+		Serializer->WriteKey(Key);
+		if (HashPtr)
+		{
+			SerializeResync(Child, Depth + 1, Hashes, Serializer);
+		}
+		else
+		{
+			Property->Serialize(Serializer);
+		}
+		Serializer->PopKey(Key);
+	}
+	Serializer->PopObject();
+}
+
+void UPsNetworkData::Synchronize(const FPsNetworkByteBuffer& Buffer, const TArray<FString>& Keys, bool bResync)
+{
+	check(!HasAuthority());
+
+	PathKeys = Keys;
+
+	if (bResync)
+	{
+		const auto InputBuffer = MakeShared<FPsDataCompressedInputStream>(Buffer.Buffer);
+		if (!InputBuffer->IsValid())
+		{
+			UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy received a corrupted resync frame"));
+			RequestSynchronize();
+			return;
+		}
+
+		DEFERRED_EVENT_PROCESSING();
+		FPsDataBinaryDeserializer Deserializer(InputBuffer);
+
+		// The changed subtrees are applied on top of the kept data without a reset
+		UPsData* This = this;
+		Deserializer.ReadValue(This, {});
+
+		UE_LOG(LogDataNetwork, Display, TEXT("Client proxy resynchronized"));
+		SynchronizePromise.Resolve();
+		return;
+	}
+
+	if (SynchronizeBudget > 0)
+	{
+		SynchronizeJob = FPsDataDeserializeJob::Start(this, MakeShared<TArray<uint8>>(Buffer.Buffer), 0, false, SynchronizeBudget);
+		SynchronizeJob->OnCompletedPromise().Bind(FSimpleDelegate::CreateUObject(this, &UPsNetworkData::OnSynchronizeCompleted));
+		return;
+	}
+
+	const auto InputBuffer = MakeShared<FPsDataCompressedInputStream>(Buffer.Buffer);
+	if (!InputBuffer->IsValid())
+	{
+		UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy received a corrupted snapshot frame"));
+		RequestSynchronize();
+		return;
+	}
 
 	DEFERRED_EVENT_PROCESSING();
-	const auto InputBuffer = MakeShared<FPsDataBufferInputStream>(Buffer.Buffer);
 	FPsDataBinaryDeserializer Deserializer(InputBuffer);
 	DataDeserialize(&Deserializer, false);
 
@@ -609,53 +1620,123 @@ void UPsNetworkData::Synchronize(const FPsNetworkByteBuffer& Buffer)
 	SynchronizePromise.Resolve();
 }
 
+void UPsNetworkData::OnSynchronizeCompleted()
+{
+	check(SynchronizeJob.IsValid());
+	const bool bCompleted = SynchronizeJob->IsCompleted();
+	SynchronizeJob.Reset();
+
+	if (!bCompleted)
+	{
+		UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy can't apply the snapshot"));
+		RequestSynchronize();
+		return;
+	}
+
+	UE_LOG(LogDataNetwork, Display, TEXT("Client proxy synchronized"));
+	SynchronizePromise.Resolve();
+
+	const auto Bundles = MoveTemp(PendingBundles);
+	for (const auto& Bundle : Bundles)
+	{
+		Apply(Bundle);
+	}
+}
+
+void UPsNetworkData::RequestSynchronize()
+{
+	PendingBundles.Reset();
+	for (const auto NetworkProxy : NetworkProxies)
+	{
+		NetworkProxy->RequestSynchronize();
+	}
+}
+
 void UPsNetworkData::Apply(const FPsNetworkEventBundle& Events)
 {
 	check(!HasAuthority());
 
+	if (SynchronizeJob.IsValid())
+	{
+		PendingBundles.Add(Events);
+		return;
+	}
+
 	DEFERRED_EVENT_PROCESSING();
 
-	const auto EventsList = Events.GetBundle();
-	for (const auto& Event : EventsList)
-	{
-		TDataPathExecutor<true, true> PathExecutor(this, Event.Path);
+	PathKeys.Append(Events.GetKeys());
+
+	// The stream and the deserializer are reused by all events of the bundle
+	FPsNetworkPathCache PathCache;
+	const auto InputStream = MakeShared<FPsDataCompressedInputStream>(TArrayView<const uint8>());
+	FPsDataBinaryDeserializer Deserializer(InputStream);
 
-		FAbstractDataProperty* Property;
-		if (PathExecutor.Execute(Property))
+	FAbstractDataProperty* Property;
+	FString Key;
+	for (const auto& Event : Events.GetBundle())
+	{
+		if (ResolvePath(Event.Path, PathCache, Property, Key))
 		{
+			if (Event.Type != EPsNetworkEventType::Removed && !InputStream->Reset(Event.Data.Buffer))
+			{
+				UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy received a corrupted event frame"));
+				RequestSynchronize();
+				return;
+			}
+
+			bool bSuccess = false;
 			if (Event.Type == EPsNetworkEventType::Changed)
 			{
-				const bool bSuccess = ApplyChanged(Property, Event.Data);
-				check(bSuccess);
+				bSuccess = ApplyChanged(Property, &Deserializer);
+			}
+			else if (Event.Type == EPsNetworkEventType::ChangedElements)
+			{
+				bSuccess = ApplyChangedElements(Property, &Deserializer);
 			}
 			else if (Event.Type == EPsNetworkEventType::Added)
 			{
-				const bool bSuccess = ApplyAddedEvent(Property, PathExecutor.GetPath(), Event.Data);
-				check(bSuccess);
+				bSuccess = ApplyAddedEvent(Property, Key, &Deserializer);
 			}
 			else if (Event.Type == EPsNetworkEventType::Removed)
 			{
-				const bool bSuccess = ApplyRemovingEvent(Property, PathExecutor.GetPath());
-				check(bSuccess);
+				bSuccess = ApplyRemovingEvent(Property, Key);
+			}
+
+			// Data doesn't match the server anymore, the rest of the bundle can't be applied on top of it
+			if (!bSuccess)
+			{
+				UE_LOG(LogDataNetwork, Warning, TEXT("Client proxy can't apply the network event"));
+				RequestSynchronize();
+				return;
 			}
 		}
+		else
+		{
+			UE_LOG(LogDataNetwork, Warning, TEXT("Can't resolve path of the network event, the event is skipped"));
+		}
 	}
 }
 
-bool UPsNetworkData::ApplyChanged(FAbstractDataProperty* Property, const FPsNetworkByteBuffer& Buffer) const
+bool UPsNetworkData::ApplyChanged(FAbstractDataProperty* Property, FPsDataBinaryDeserializer* Deserializer) const
 {
-	FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataBufferInputStream>(Buffer.Buffer));
-	Property->Deserialize(&Deserializer);
+	Property->Deserialize(Deserializer);
 	return true;
 }
 
-bool UPsNetworkData::ApplyAddedEvent(FAbstractDataProperty* Property, const FString& Key, const FPsNetworkByteBuffer& Buffer) const
+bool UPsNetworkData::ApplyChangedElements(FAbstractDataProperty* Property, FPsDataBinaryDeserializer* Deserializer) const
+{
+	return Property->ApplyDelta(Deserializer);
+}
+
+bool UPsNetworkData::ApplyAddedEvent(FAbstractDataProperty* Property, const FString& Key, FPsDataBinaryDeserializer* Deserializer) const
 {
 	const auto Field = Property->GetField();
-	check(Field->Context->IsData());
+	if (!Field->Context->IsData())
+	{
+		return false;
+	}
 
-	FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataBufferInputStream>(Buffer.Buffer));
-	UPsData* NewData = static_cast<UPsData*>(UPsDataUPsDataLibrary::TypeDeserialize(Property->GetOwner(), Field, &Deserializer, nullptr));
+	UPsData* NewData = static_cast<UPsData*>(UPsDataUPsDataLibrary::TypeDeserialize(Property->GetOwner(), Field, Deserializer, nullptr));
 
 	if (Field->Context->IsArray())
 	{
@@ -663,8 +1744,11 @@ bool UPsNetworkData::ApplyAddedEvent(FAbstractDataProperty* Property, const FStr
 		if (GetContext<TArray<UPsData*>>().IsA(Field->Context) && IndexOpt)
 		{
 			TPsDataArrayProxy<UPsData*> Proxy(static_cast<TDataProperty<TArray<UPsData*>>*>(Property));
-			Proxy.Insert(NewData, IndexOpt.GetValue());
-			return true;
+			if (IndexOpt.GetValue() <= Proxy.Num())
+			{
+				Proxy.Insert(NewData, IndexOpt.GetValue());
+				return true;
+			}
 		}
 	}
 	else if (Field->Context->IsMap())
@@ -692,7 +1776,10 @@ bool UPsNetworkData::ApplyAddedEvent(FAbstractDataProperty* Property, const FStr
 bool UPsNetworkData::ApplyRemovingEvent(FAbstractDataProperty* Property, const FString& Key) const
 {
 	const auto Field = Property->GetField();
-	check(Field->Context->IsData());
+	if (!Field->Context->IsData())
+	{
+		return false;
+	}
 
 	if (Field->Context->IsArray())
 	{
@@ -732,5 +1819,11 @@ bool UPsNetworkData::ApplyRemovingEvent(FAbstractDataProperty* Property, const F
 void UPsNetworkData::MutableReset() const
 {
 	SynchronizePromise.Reset();
-	const_cast<UPsNetworkData*>(this)->Reset();
+	PathKeys.Reset();
+
+	// With resync enabled the data is kept to be resynchronized by hash on the next connection
+	if (ResyncDepth <= 0)
+	{
+		const_cast<UPsNetworkData*>(this)->Reset();
+	}
 }
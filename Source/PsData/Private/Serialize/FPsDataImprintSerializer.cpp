@@ -102,7 +102,7 @@ const FPsDataMD5Hash& FPsDataImprint::GetHash() const
  * FPsDataImprintBinarySerializer
  ***********************************/
 
-uint32 FPsDataImprintBinarySerializer::Concatenate(TSharedRef<FPsDataBufferOutputStream>& OutputStream, const UPsData* Data)
+uint32 FPsDataImprintBinarySerializer::Concatenate(TSharedRef<FPsDataChunkedOutputStream>& OutputStream, const UPsData* Data)
 {
 	const auto& Imprint = PsDataTools::FPsDataFriend::GetImprint(Data);
 	if (Imprint.HasChildren())
@@ -116,37 +116,42 @@ uint32 FPsDataImprintBinarySerializer::Concatenate(TSharedRef<FPsDataBufferOutpu
 			ChildrenOffsets.Add(Offset);
 		}
 
-		const auto ResultOffset = OutputStream->Size();
-		TArray<uint8> BufferCopy = Imprint.GetBuffer();
-		auto BufferCopyPtr = BufferCopy.GetData();
+		const auto& Buffer = Imprint.GetBuffer();
 		const auto& Children = Imprint.GetChildren();
-		for (int32 i = 0; i < ChildrenOffsets.Num(); ++i)
+
+		// Children are sorted by key, but the buffer is written in slot order
+		TArray<int32, TInlineAllocator<32>> SlotOrder;
+		SlotOrder.Reserve(Children.Num());
+		for (int32 i = 0; i < Children.Num(); ++i)
+		{
+			SlotOrder.Add(i);
+		}
+		SlotOrder.Sort([&Children](int32 A, int32 B) {
+			return Children[A].GetOffsets() < Children[B].GetOffsets();
+		});
+
+		// Unchanged imprint spans are referenced, only redirect slots are written
+		const auto ResultOffset = OutputStream->Size();
+		int32 SpanBegin = 0;
+		for (const auto i : SlotOrder)
 		{
-			const auto ChildOffset = ChildrenOffsets[i];
 			const auto BufferOffset = Children[i].GetOffsets();
+			check(Buffer[BufferOffset] == 0);
 
-			if (BufferCopyPtr[BufferOffset] == 0)
-			{
-				BufferCopyPtr[BufferOffset] = EBinaryTokens::Redirect;
-				BufferCopyPtr[BufferOffset + 1] = static_cast<uint8>(ChildOffset >> 24);
-				BufferCopyPtr[BufferOffset + 2] = static_cast<uint8>(ChildOffset >> 16);
-				BufferCopyPtr[BufferOffset + 3] = static_cast<uint8>(ChildOffset >> 8);
-				BufferCopyPtr[BufferOffset + 4] = static_cast<uint8>(ChildOffset);
-			}
-			else
-			{
-				checkNoEntry();
-			}
+			OutputStream->WriteBufferReference(Buffer.GetData() + SpanBegin, BufferOffset - SpanBegin);
+			OutputStream->WriteUint8(EBinaryTokens::Redirect);
+			OutputStream->WriteUint32(ChildrenOffsets[i]);
+			SpanBegin = BufferOffset + RedirectSlotSize;
 		}
-
-		OutputStream->WriteBuffer(std::move(BufferCopy));
+		OutputStream->WriteBufferReference(Buffer.GetData() + SpanBegin, Buffer.Num() - SpanBegin);
 		OutputStream->WriteUint8(EBinaryTokens::RedirectEnd);
 		return ResultOffset;
 	}
 	else
 	{
 		const auto ResultOffset = OutputStream->Size();
-		OutputStream->WriteBuffer(Imprint.GetBuffer());
+		const auto& Buffer = Imprint.GetBuffer();
+		OutputStream->WriteBufferReference(Buffer.GetData(), Buffer.Num());
 		OutputStream->WriteUint8(EBinaryTokens::RedirectEnd);
 		return ResultOffset;
 	}
@@ -176,7 +181,7 @@ void FPsDataImprintBinarySerializer::WriteValue(const UPsData* Value)
  * FPsDataImprintBinaryDeserializer
  ***********************************/
 
-FPsDataImprintBinaryDeserializer::FPsDataImprintBinaryDeserializer(TSharedRef<FPsDataBufferInputStream> InInputStream, int32 InOffset)
+FPsDataImprintBinaryDeserializer::FPsDataImprintBinaryDeserializer(TSharedRef<FPsDataInputStream> InInputStream, int32 InOffset)
 	: FPsDataBinaryDeserializer(InInputStream)
 {
 	InInputStream->SetPosition(InOffset);
@@ -193,6 +198,11 @@ uint8 FPsDataImprintBinaryDeserializer::ReadToken()
 	return Token;
 }
 
+bool FPsDataImprintBinaryDeserializer::SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements)
+{
+	return false;
+}
+
 bool FPsDataImprintBinaryDeserializer::TryToRedirect(uint8 Token)
 {
 	if (Token == EBinaryTokens::Redirect)
@@ -273,6 +283,12 @@ void FPsDataImprintBinaryConvertor::Convert(FPsDataSerializer* Serializer)
 		case EBinaryTokens::Value_null:
 			ReadNull(Serializer);
 			break;
+		case EBinaryTokens::Deleted:
+			ReadDeleted(Serializer);
+			break;
+		case EBinaryTokens::TypedArray:
+			ReadTypedArray(Serializer);
+			break;
 		default:
 			bRunning = false;
 		}
@@ -330,3 +346,33 @@ void FPsDataImprintBinaryConvertor::ReadNull(FPsDataSerializer* Serializer)
 	Deserializer->ReadToken();
 	Serializer->WriteValue(nullptr);
 }
+
+void FPsDataImprintBinaryConvertor::ReadDeleted(FPsDataSerializer* Serializer)
+{
+	Deserializer->ReadToken();
+	Serializer->WriteDeleted();
+}
+
+void FPsDataImprintBinaryConvertor::ReadTypedArray(FPsDataSerializer* Serializer)
+{
+	switch (Deserializer->PeekTypedArrayToken())
+	{
+	case EBinaryTokens::Value_uint8:
+		ReadValues<uint8>(Serializer);
+		break;
+	case EBinaryTokens::Value_int32:
+		ReadValues<int32>(Serializer);
+		break;
+	case EBinaryTokens::Value_int64:
+		ReadValues<int64>(Serializer);
+		break;
+	case EBinaryTokens::Value_float:
+		ReadValues<float>(Serializer);
+		break;
+	case EBinaryTokens::Value_bool:
+		ReadValues<bool>(Serializer);
+		break;
+	default:
+		checkNoEntry();
+	}
+}
@@ -3,6 +3,75 @@
 #include "Serialize/PsDataBinarySerialization.h"
 
 #include "PsData.h"
+#include "Serialize/Stream/PsDataBufferOutputStream.h"
+
+#include "Algo/Reverse.h"
+
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+static_assert(sizeof(bool) == 1, "Typed array of bool expects one byte per element");
+
+// Typed arrays are stored in little-endian order, so the bytes are a plain copy of the array memory on most platforms
+template <typename T>
+void SwapTypedArrayBytes(T* Values, int32 Num)
+{
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Algo::Reverse(reinterpret_cast<uint8*>(&Values[i]), sizeof(T));
+	}
+}
+
+// Raw bytes of a bool array can hold any value, they are brought to 0/1 before the elements are read as bool
+template <typename T>
+void NormalizeTypedArray(T* Values, int32 Num)
+{
+}
+
+void NormalizeTypedArray(bool* Values, int32 Num)
+{
+	uint8* Bytes = reinterpret_cast<uint8*>(Values);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		Bytes[i] = Bytes[i] != 0 ? 1 : 0;
+	}
+}
+
+template <typename T>
+bool CopyBinaryValue(FPsDataBinaryDeserializer* Deserializer, FPsDataSerializer* Serializer)
+{
+	T Value;
+	if (!Deserializer->ReadValue(Value))
+	{
+		return false;
+	}
+
+	if (Serializer)
+	{
+		Serializer->WriteValue(Value);
+	}
+	return true;
+}
+
+template <typename T>
+bool CopyBinaryValues(FPsDataBinaryDeserializer* Deserializer, FPsDataSerializer* Serializer)
+{
+	TArray<T> Values;
+	if (!Deserializer->ReadValues(Values))
+	{
+		return false;
+	}
+
+	if (Serializer)
+	{
+		Serializer->WriteValues(Values);
+	}
+	return true;
+}
+} // namespace PsDataTools
 
 /***********************************
  * FBinaryDataSerializer
@@ -92,6 +161,61 @@ void FPsDataBinarySerializer::WriteValue(const UPsData* Value)
 	}
 }
 
+void FPsDataBinarySerializer::WriteValues(const TArray<int32>& Values)
+{
+	WriteTypedArray(EBinaryTokens::Value_int32, Values);
+}
+
+void FPsDataBinarySerializer::WriteValues(const TArray<int64>& Values)
+{
+	WriteTypedArray(EBinaryTokens::Value_int64, Values);
+}
+
+void FPsDataBinarySerializer::WriteValues(const TArray<uint8>& Values)
+{
+	WriteTypedArray(EBinaryTokens::Value_uint8, Values);
+}
+
+void FPsDataBinarySerializer::WriteValues(const TArray<float>& Values)
+{
+	WriteTypedArray(EBinaryTokens::Value_float, Values);
+}
+
+void FPsDataBinarySerializer::WriteValues(const TArray<bool>& Values)
+{
+	WriteTypedArray(EBinaryTokens::Value_bool, Values);
+}
+
+template <typename T>
+void FPsDataBinarySerializer::WriteTypedArray(uint8 ElementToken, const TArray<T>& Values)
+{
+	OutputStream->WriteUint8(EBinaryTokens::TypedArray);
+	OutputStream->WriteUint8(ElementToken);
+	OutputStream->WriteUint32(static_cast<uint32>(Values.Num()));
+
+	if (Values.Num() > 0)
+	{
+#if PLATFORM_LITTLE_ENDIAN
+		OutputStream->WriteBuffer(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(T));
+#else
+		TArray<T> ValuesCopy = Values;
+		PsDataTools::SwapTypedArrayBytes(ValuesCopy.GetData(), ValuesCopy.Num());
+		OutputStream->WriteBuffer(reinterpret_cast<const uint8*>(ValuesCopy.GetData()), ValuesCopy.Num() * sizeof(T));
+#endif
+	}
+}
+
+void FPsDataBinarySerializer::WriteDeleted()
+{
+	OutputStream->WriteUint8(EBinaryTokens::Deleted);
+}
+
+bool FPsDataBinarySerializer::WriteBinaryValue(const TArray<uint8>& Bytes)
+{
+	OutputStream->WriteBuffer(Bytes);
+	return true;
+}
+
 void FPsDataBinarySerializer::PopKey(const FString& Key)
 {
 	OutputStream->WriteUint8(EBinaryTokens::KeyEnd);
@@ -275,6 +399,263 @@ bool FPsDataBinaryDeserializer::ReadValue(UPsData*& OutValue, FPsDataAllocator A
 	return false;
 }
 
+bool FPsDataBinaryDeserializer::ReadValues(TArray<int32>& OutValues)
+{
+	return ReadTypedArray(EBinaryTokens::Value_int32, OutValues);
+}
+
+bool FPsDataBinaryDeserializer::ReadValues(TArray<int64>& OutValues)
+{
+	return ReadTypedArray(EBinaryTokens::Value_int64, OutValues);
+}
+
+bool FPsDataBinaryDeserializer::ReadValues(TArray<uint8>& OutValues)
+{
+	return ReadTypedArray(EBinaryTokens::Value_uint8, OutValues);
+}
+
+bool FPsDataBinaryDeserializer::ReadValues(TArray<float>& OutValues)
+{
+	return ReadTypedArray(EBinaryTokens::Value_float, OutValues);
+}
+
+bool FPsDataBinaryDeserializer::ReadValues(TArray<bool>& OutValues)
+{
+	return ReadTypedArray(EBinaryTokens::Value_bool, OutValues);
+}
+
+uint8 FPsDataBinaryDeserializer::PeekTypedArrayToken()
+{
+	if (CheckToken(EBinaryTokens::TypedArray))
+	{
+		const auto ElementToken = InputStream->ReadUint8();
+		InputStream->SetPosition(InputStream->GetPosition() - 2);
+		return ElementToken;
+	}
+
+	return EBinaryTokens::Null;
+}
+
+bool FPsDataBinaryDeserializer::SkipValue()
+{
+	return CopyValue(nullptr);
+}
+
+bool FPsDataBinaryDeserializer::CopyValue(FPsDataSerializer* Serializer)
+{
+	const auto Token = ReadToken();
+	InputStream->ShiftBack();
+
+	switch (Token)
+	{
+	case EBinaryTokens::ObjectBegin:
+	{
+		ReadObject();
+		if (Serializer)
+		{
+			Serializer->WriteObject();
+		}
+
+		FString Key;
+		while (ReadKey(Key))
+		{
+			if (Serializer)
+			{
+				Serializer->WriteKey(Key);
+			}
+			if (!CopyValue(Serializer))
+			{
+				return false;
+			}
+			if (Serializer)
+			{
+				Serializer->PopKey(Key);
+			}
+			PopKey(Key);
+		}
+
+		PopObject();
+		if (Serializer)
+		{
+			Serializer->PopObject();
+		}
+		return true;
+	}
+	case EBinaryTokens::ArrayBegin:
+		ReadArray();
+		if (Serializer)
+		{
+			Serializer->WriteArray();
+		}
+
+		while (ReadIndex())
+		{
+			if (!CopyValue(Serializer))
+			{
+				return false;
+			}
+			PopIndex();
+		}
+
+		PopArray();
+		if (Serializer)
+		{
+			Serializer->PopArray();
+		}
+		return true;
+	case EBinaryTokens::Value_uint8:
+		return PsDataTools::CopyBinaryValue<uint8>(this, Serializer);
+	case EBinaryTokens::Value_int32:
+		return PsDataTools::CopyBinaryValue<int32>(this, Serializer);
+	case EBinaryTokens::Value_int64:
+		return PsDataTools::CopyBinaryValue<int64>(this, Serializer);
+	case EBinaryTokens::Value_float:
+		return PsDataTools::CopyBinaryValue<float>(this, Serializer);
+	case EBinaryTokens::Value_bool:
+		return PsDataTools::CopyBinaryValue<bool>(this, Serializer);
+	case EBinaryTokens::Value_FString:
+		return PsDataTools::CopyBinaryValue<FString>(this, Serializer);
+	case EBinaryTokens::Value_FName:
+		return PsDataTools::CopyBinaryValue<FName>(this, Serializer);
+	case EBinaryTokens::Value_null:
+		ReadToken();
+		if (Serializer)
+		{
+			Serializer->WriteValue(static_cast<const UPsData*>(nullptr));
+		}
+		return true;
+	case EBinaryTokens::Deleted:
+		ReadToken();
+		if (Serializer)
+		{
+			Serializer->WriteDeleted();
+		}
+		return true;
+	case EBinaryTokens::TypedArray:
+		switch (PeekTypedArrayToken())
+		{
+		case EBinaryTokens::Value_uint8:
+			return PsDataTools::CopyBinaryValues<uint8>(this, Serializer);
+		case EBinaryTokens::Value_int32:
+			return PsDataTools::CopyBinaryValues<int32>(this, Serializer);
+		case EBinaryTokens::Value_int64:
+			return PsDataTools::CopyBinaryValues<int64>(this, Serializer);
+		case EBinaryTokens::Value_float:
+			return PsDataTools::CopyBinaryValues<float>(this, Serializer);
+		case EBinaryTokens::Value_bool:
+			return PsDataTools::CopyBinaryValues<bool>(this, Serializer);
+		default:
+			return false;
+		}
+	default:
+		return false;
+	}
+}
+
+TSharedPtr<const TArray<uint8>> FPsDataBinaryDeserializer::ReadBinaryValue()
+{
+	const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+	FPsDataBinarySerializer Serializer(OutputStream);
+	if (!CopyValue(&Serializer))
+	{
+		return nullptr;
+	}
+
+	return MakeShared<TArray<uint8>>(MoveTemp(OutputStream->GetBuffer()));
+}
+
+bool FPsDataBinaryDeserializer::SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements)
+{
+	if (!InputStream->Fork().IsValid())
+	{
+		return false;
+	}
+
+	// Malformed element is left to the serial path, it reports the error at the right place
+	const int32 StartPosition = InputStream->GetPosition();
+	const int32 NumKeys = OutKeys ? OutKeys->Num() : 0;
+
+	TArray<int32> Positions;
+	if (OutKeys)
+	{
+		FString Key;
+		while (ReadKey(Key))
+		{
+			OutKeys->Add(Key);
+			Positions.Add(InputStream->GetPosition());
+			if (!SkipValue())
+			{
+				OutKeys->SetNum(NumKeys);
+				InputStream->SetPosition(StartPosition);
+				return false;
+			}
+			PopKey(Key);
+		}
+	}
+	else
+	{
+		while (ReadIndex())
+		{
+			Positions.Add(InputStream->GetPosition());
+			if (!SkipValue())
+			{
+				InputStream->SetPosition(StartPosition);
+				return false;
+			}
+			PopIndex();
+		}
+	}
+
+	OutElements.Reserve(Positions.Num());
+	for (const int32 ElementPosition : Positions)
+	{
+		auto Stream = InputStream->Fork();
+		Stream->SetPosition(ElementPosition);
+		OutElements.Add(MakeUnique<FPsDataBinaryDeserializer>(Stream.ToSharedRef()));
+	}
+
+	return true;
+}
+
+bool FPsDataBinaryDeserializer::ReadDeleted()
+{
+	return CheckToken(EBinaryTokens::Deleted);
+}
+
+template <typename T>
+bool FPsDataBinaryDeserializer::ReadTypedArray(uint8 ElementToken, TArray<T>& OutValues)
+{
+	if (PeekTypedArrayToken() != ElementToken)
+	{
+		// Element by element array from the older data
+		return FPsDataDeserializer::ReadValues(OutValues);
+	}
+
+	InputStream->ReadUint8();
+	InputStream->ReadUint8();
+	const int32 Num = static_cast<int32>(InputStream->ReadUint32());
+
+	// The size comes from the data, so it is checked against the rest of the stream before allocating
+	const int64 Remaining = static_cast<int64>(InputStream->GetSize()) - InputStream->GetPosition();
+	if (Num < 0 || static_cast<int64>(Num) * static_cast<int64>(sizeof(T)) > Remaining)
+	{
+		UE_LOG(LogData, Warning, TEXT("Typed array of %d elements exceeds the rest of the stream (%lld bytes)"), Num, Remaining);
+		return false;
+	}
+
+	OutValues.SetNumUninitialized(Num);
+	if (Num > 0)
+	{
+		InputStream->ReadBuffer(reinterpret_cast<uint8*>(OutValues.GetData()), Num * sizeof(T));
+		PsDataTools::NormalizeTypedArray(OutValues.GetData(), OutValues.Num());
+#if !PLATFORM_LITTLE_ENDIAN
+		PsDataTools::SwapTypedArrayBytes(OutValues.GetData(), OutValues.Num());
+#endif
+	}
+
+	return true;
+}
+
 void FPsDataBinaryDeserializer::PopKey(const FString& Key)
 {
 	const bool bSuccess = CheckToken(EBinaryTokens::KeyEnd);
@@ -0,0 +1,241 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/PsDataDeserializeJob.h"
+
+#include "PsData.h"
+#include "PsDataCore.h"
+#include "Serialize/FPsDataImprintSerializer.h"
+#include "Serialize/Stream/PsDataBufferOutputStream.h"
+#include "Serialize/Stream/PsDataCompressedInputStream.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
+
+#include "Async/Async.h"
+
+/***********************************
+ * FPsDataDeserializeJob
+ ***********************************/
+
+TSharedRef<FPsDataDeserializeJob> FPsDataDeserializeJob::Start(UPsData* Data, TSharedRef<TArray<uint8>> Buffer, int32 Offset, bool bPatch, int32 Budget, bool bParallelCollections)
+{
+	check(IsInGameThread());
+	check(Data);
+
+	auto Job = MakeShared<FPsDataDeserializeJob>(Data, bPatch, Budget, bParallelCollections);
+
+	TWeakPtr<FPsDataDeserializeJob> WeakJob = Job;
+	AsyncTask(ENamedThreads::AnyHiPriThreadHiPriTask, [WeakJob, Buffer, Offset]() {
+		auto InTape = Parse(Buffer, Offset);
+		AsyncTask(ENamedThreads::GameThread, [WeakJob, InTape]() {
+			if (const auto PinnedJob = WeakJob.Pin())
+			{
+				PinnedJob->BeginApply(InTape);
+			}
+		});
+	});
+
+	return Job;
+}
+
+FPsDataDeserializeJob::FPsDataDeserializeJob(UPsData* InData, bool bInPatch, int32 InBudget, bool bInParallelCollections)
+	: Data(InData)
+	, bPatch(bInPatch)
+	, bParallelCollections(bInParallelCollections)
+	, Budget(FMath::Max(InBudget, 1))
+	, State(EState::Parsing)
+{
+}
+
+FPsDataDeserializeJob::~FPsDataDeserializeJob()
+{
+	// Released job is cancelled, the completed promise is resolved anyway
+	if (State == EState::Parsing || State == EState::Applying)
+	{
+		Finish(EState::Failed);
+	}
+}
+
+void FPsDataDeserializeJob::Cancel()
+{
+	if (State == EState::Parsing || State == EState::Applying)
+	{
+		UE_LOG(LogData, Warning, TEXT("Deserialize job is cancelled"));
+		Finish(EState::Failed);
+	}
+}
+
+bool FPsDataDeserializeJob::IsCompleted() const
+{
+	return State == EState::Completed;
+}
+
+bool FPsDataDeserializeJob::IsFailed() const
+{
+	return State == EState::Failed;
+}
+
+float FPsDataDeserializeJob::GetProgress() const
+{
+	if (State == EState::Completed)
+	{
+		return 1.f;
+	}
+
+	if (State == EState::Applying && Tape->Num() > 0)
+	{
+		return static_cast<float>(Deserializer->GetInputStream()->GetPosition()) / Tape->Num();
+	}
+
+	return 0.f;
+}
+
+FPsDataSimplePromise& FPsDataDeserializeJob::OnParsedPromise()
+{
+	return ParsedPromise;
+}
+
+FPsDataSimplePromise& FPsDataDeserializeJob::OnCompletedPromise()
+{
+	return CompletedPromise;
+}
+
+TSharedRef<TArray<uint8>> FPsDataDeserializeJob::Parse(TSharedRef<TArray<uint8>> Buffer, int32 Offset)
+{
+	// Compression frame and imprint redirects are resolved once, the tape is a flat binary token stream
+	const auto InputStream = MakeShared<FPsDataCompressedInputStream>(Buffer.Get());
+	const auto TapeStream = MakeShared<FPsDataBufferOutputStream>();
+	if (InputStream->IsValid())
+	{
+		TapeStream->Reserve(InputStream->GetView().Num());
+
+		FPsDataImprintBinaryDeserializer ImprintDeserializer(InputStream, Offset);
+		FPsDataImprintBinaryConvertor Convertor(&ImprintDeserializer);
+		FPsDataBinarySerializer TapeSerializer(TapeStream);
+		Convertor.Convert(&TapeSerializer);
+	}
+
+	return MakeShared<TArray<uint8>>(MoveTemp(TapeStream->GetBuffer()));
+}
+
+void FPsDataDeserializeJob::BeginApply(TSharedRef<TArray<uint8>> InTape)
+{
+	if (State != EState::Parsing)
+	{
+		return;
+	}
+
+	Tape = InTape;
+	Deserializer = MakeUnique<FPsDataBinaryDeserializer>(MakeShared<FPsDataViewInputStream>(*Tape));
+	Deserializer->bPatch = bPatch;
+	Deserializer->bParallelCollections = bParallelCollections;
+
+	UPsData* Root = Data.Get();
+	if (!Root || !Deserializer->ReadObject())
+	{
+		UE_LOG(LogData, Error, TEXT("Deserialize job can't read the snapshot"));
+		Finish(EState::Failed);
+		return;
+	}
+
+	State = EState::Applying;
+	EventScopeGuard = MakeUnique<FPsDataEventScopeGuard>();
+
+	if (!bPatch)
+	{
+		Root->Reset();
+	}
+
+	Stack.Push({Root, FString()});
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FPsDataDeserializeJob::Tick));
+
+	ParsedPromise.Resolve();
+}
+
+bool FPsDataDeserializeJob::Tick(float DeltaTime)
+{
+	const double EndTime = FPlatformTime::Seconds() + Budget * 0.000001;
+	while (Step())
+	{
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return true;
+		}
+	}
+
+	// Ticker is removed by returning false
+	TickerHandle.Reset();
+	Finish(Stack.Num() == 0 ? EState::Completed : EState::Failed);
+	return false;
+}
+
+bool FPsDataDeserializeJob::Step()
+{
+	if (Stack.Num() == 0)
+	{
+		return false;
+	}
+
+	UPsData* Current = Stack.Last().Data.Get();
+	if (!Current)
+	{
+		UE_LOG(LogData, Error, TEXT("Deserialize job lost the target data"));
+		return false;
+	}
+
+	FString Key;
+	if (Deserializer->ReadKey(Key))
+	{
+		const auto Field = PsDataTools::FDataReflection::GetFieldsByClass(Current->GetClass())->GetFieldByAlias(Key);
+		if (!Field)
+		{
+			UE_LOG(LogData, Warning, TEXT("Property \"%s\" not found in \"%s\""), *Key, *Current->GetClass()->GetName())
+			Deserializer->PopKey(Key);
+			return true;
+		}
+
+		// Existing child data is entered instead of being deserialized at once, so it's split between slices
+		if (Field->Context->IsData() && !Field->Context->IsContainer())
+		{
+			UPsData** ChildPtr = nullptr;
+			if (PsDataTools::GetByField<false>(Current, Field, ChildPtr) && *ChildPtr && Deserializer->ReadObject())
+			{
+				Stack.Push({*ChildPtr, Key});
+				return true;
+			}
+		}
+
+		PsDataTools::FPsDataFriend::GetProperty(Current, Field->Index)->Deserialize(Deserializer.Get());
+		Deserializer->PopKey(Key);
+		return true;
+	}
+
+	Deserializer->PopObject();
+	PsDataTools::FPsDataFriend::PostDeserialize(Current);
+
+	const FFrame Frame = Stack.Pop(false);
+	if (Stack.Num() > 0)
+	{
+		Deserializer->PopKey(Frame.Key);
+		return true;
+	}
+
+	return false;
+}
+
+void FPsDataDeserializeJob::Finish(EState NewState)
+{
+	if (TickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+
+	State = NewState;
+	Stack.Reset();
+	Deserializer.Reset();
+	Tape.Reset();
+
+	// Held back events are broadcasted here
+	EventScopeGuard.Reset();
+
+	CompletedPromise.Resolve();
+}
@@ -481,6 +481,7 @@ FPsDataFastJsonDeserializer::FPsDataFastJsonDeserializer(const FString& InJsonSt
 	: FPsDataDeserializer()
 	, Source(InJsonString.GetCharArray().GetData())
 	, Size(InJsonString.Len())
+	, Pointers(OwnPointers)
 	, PointerIndex(0)
 {
 	Pointers.Reserve(100);
@@ -489,6 +490,16 @@ FPsDataFastJsonDeserializer::FPsDataFastJsonDeserializer(const FString& InJsonSt
 	DepthStack.Reserve(10);
 }
 
+FPsDataFastJsonDeserializer::FPsDataFastJsonDeserializer(const TCHAR* InSource, int32 InSize, TArray<FPsDataFastJsonPointer>& InPointers, int32 InPointerIndex)
+	: FPsDataDeserializer()
+	, Source(InSource)
+	, Size(InSize)
+	, Pointers(InPointers)
+	, PointerIndex(InPointerIndex)
+{
+	DepthStack.Reserve(10);
+}
+
 void FPsDataFastJsonDeserializer::Parse()
 {
 	int32 PrevIndex = -1;
@@ -789,6 +800,39 @@ bool FPsDataFastJsonDeserializer::ReadValue(UPsData*& OutValue, FPsDataAllocator
 	return false;
 }
 
+bool FPsDataFastJsonDeserializer::SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements)
+{
+	if (OutKeys)
+	{
+		FString Key;
+		while (ReadKey(Key))
+		{
+			OutKeys->Add(Key);
+			OutElements.Add(TUniquePtr<FPsDataDeserializer>(new FPsDataFastJsonDeserializer(Source, Size, Pointers, PointerIndex)));
+			PopKey(Key);
+		}
+		return true;
+	}
+
+	// Element ends with the comma or the end of the array at the array depth
+	const int32 Depth = DepthStack.Last();
+	while (ReadIndex())
+	{
+		SkipComma();
+		OutElements.Add(TUniquePtr<FPsDataDeserializer>(new FPsDataFastJsonDeserializer(Source, Size, Pointers, PointerIndex)));
+
+		int32 i = PointerIndex + 1;
+		while (i < Pointers.Num() && Pointers[i].Depth != Depth)
+		{
+			++i;
+		}
+
+		check(i < Pointers.Num());
+		PointerIndex = i;
+	}
+	return true;
+}
+
 void FPsDataFastJsonDeserializer::PopKey(const FString& Key)
 {
 	const int32 Depth = DepthStack.Pop(false);
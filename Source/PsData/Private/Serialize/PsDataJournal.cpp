@@ -0,0 +1,545 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/PsDataJournal.h"
+
+#include "PsDataAPI.h"
+#include "Serialize/PsDataBinarySerialization.h"
+#include "Serialize/Stream/PsDataBufferOutputStream.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
+
+#include "Async/Async.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+constexpr uint32 JournalSnapshotMagic = 0x5053444A; // PSDJ
+constexpr uint32 JournalMagic = 0x5053444C;         // PSDL
+constexpr int32 JournalHeaderSize = 8;
+constexpr int32 JournalBatchHeaderSize = 8;
+
+TArray<uint8> MakeJournalHeader(uint32 Magic, uint32 Generation)
+{
+	FPsDataBufferOutputStream OutputStream;
+	OutputStream.WriteUint32(Magic);
+	OutputStream.WriteUint32(Generation);
+	return MoveTemp(OutputStream.GetBuffer());
+}
+
+bool WriteJournalFile(const FString& Filename, const TArray<uint8>& Header, const TArray<uint8>& Bytes, bool bAppend)
+{
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename, bAppend));
+	return Handle.IsValid() && Handle->Write(Header.GetData(), Header.Num()) && Handle->Write(Bytes.GetData(), Bytes.Num()) && (bAppend || Handle->Flush(true));
+}
+
+/** Complete temp file is renamed over the snapshot, the snapshot is only removed first where rename can't replace a file */
+bool ReplaceJournalSnapshot(const FString& Filename, const FString& TempFilename)
+{
+	auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.MoveFile(*Filename, *TempFilename))
+	{
+		return true;
+	}
+
+	return (!PlatformFile.FileExists(*Filename) || PlatformFile.DeleteFile(*Filename)) && PlatformFile.MoveFile(*Filename, *TempFilename);
+}
+} // namespace PsDataTools
+
+/***********************************
+ * FPsDataJournal::FWriter
+ ***********************************/
+
+void FPsDataJournal::FWriter::Enqueue(TFunction<void()>&& Task)
+{
+	FScopeLock Lock(&CriticalSection);
+	Tasks.Add(MoveTemp(Task));
+
+	if (!bRunning)
+	{
+		bRunning = true;
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [This = AsShared()]() {
+			This->Drain();
+		});
+	}
+}
+
+void FPsDataJournal::FWriter::Drain()
+{
+	while (true)
+	{
+		TArray<TFunction<void()>> Batch;
+		{
+			FScopeLock Lock(&CriticalSection);
+			if (Tasks.Num() == 0)
+			{
+				bRunning = false;
+				return;
+			}
+			Batch = MoveTemp(Tasks);
+		}
+
+		for (const auto& Task : Batch)
+		{
+			Task();
+		}
+	}
+}
+
+/***********************************
+ * FPsDataJournal
+ ***********************************/
+
+FPsDataJournal::FPsDataJournal(UPsData* InData, const FString& InFilename)
+	: FlushInterval(DefaultFlushInterval)
+	, CompactionSize(DefaultCompactionSize)
+	, Data(InData)
+	, Filename(InFilename)
+	, JournalFilename(InFilename + TEXT(".journal"))
+	, JournalSize(0)
+	, bSnapshot(false)
+	, bAttached(false)
+	, bReplaying(false)
+	, Writer(MakeShared<FWriter>())
+{
+	check(InData);
+}
+
+FPsDataJournal::~FPsDataJournal()
+{
+	Detach();
+}
+
+bool FPsDataJournal::Load()
+{
+	check(IsInGameThread());
+
+	UPsData* Target = Data.Get();
+	if (!Target)
+	{
+		return false;
+	}
+
+	// Compaction was stopped after the snapshot was removed, the temp file is complete at this point
+	auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempFilename = Filename + TEXT(".tmp");
+	if (!PlatformFile.FileExists(*Filename) && PlatformFile.FileExists(*TempFilename))
+	{
+		UE_LOG(LogData, Warning, TEXT("Snapshot \"%s\" is restored from the compacted file"), *Filename);
+		PlatformFile.MoveFile(*Filename, *TempFilename);
+	}
+
+	TArray<uint8> SnapshotBuffer;
+	if (!FFileHelper::LoadFileToArray(SnapshotBuffer, *Filename, FILEREAD_Silent) || SnapshotBuffer.Num() < PsDataTools::JournalHeaderSize)
+	{
+		return false;
+	}
+
+	FPsDataViewInputStream SnapshotHeader(SnapshotBuffer);
+	if (SnapshotHeader.ReadUint32() != PsDataTools::JournalSnapshotMagic)
+	{
+		UE_LOG(LogData, Warning, TEXT("Snapshot \"%s\" is broken"), *Filename);
+		return false;
+	}
+
+	const uint32 Generation = SnapshotHeader.ReadUint32();
+	Writer->Enqueue([Writer = Writer, Generation]() {
+		Writer->Generation = Generation;
+	});
+
+	DEFERRED_EVENT_PROCESSING();
+	TGuardValue<bool> ReplayGuard(bReplaying, true);
+
+	FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataViewInputStream>(MakeArrayView(SnapshotBuffer).Slice(PsDataTools::JournalHeaderSize, SnapshotBuffer.Num() - PsDataTools::JournalHeaderSize)));
+	Target->DataDeserialize(&Deserializer);
+	bSnapshot = true;
+
+	// Journal of another generation is already in the snapshot: the process was stopped in the middle of compaction
+	TArray<uint8> JournalBuffer;
+	JournalSize = 0;
+	if (FFileHelper::LoadFileToArray(JournalBuffer, *JournalFilename, FILEREAD_Silent) && JournalBuffer.Num() >= PsDataTools::JournalHeaderSize)
+	{
+		FPsDataViewInputStream JournalHeader(JournalBuffer);
+		if (JournalHeader.ReadUint32() == PsDataTools::JournalMagic && JournalHeader.ReadUint32() == Generation)
+		{
+			JournalSize = Replay(JournalBuffer);
+		}
+	}
+
+	// Torn tail of the journal is cut off, so the next batches are appended after the valid ones
+	if (JournalSize == 0)
+	{
+		ResetJournal();
+	}
+	else if (JournalSize != JournalBuffer.Num())
+	{
+		JournalBuffer.SetNum(JournalSize);
+		Writer->Enqueue([JournalFilename = JournalFilename, JournalBuffer = MoveTemp(JournalBuffer)]() {
+			FFileHelper::SaveArrayToFile(JournalBuffer, *JournalFilename);
+		});
+	}
+
+	return true;
+}
+
+void FPsDataJournal::Attach()
+{
+	check(IsInGameThread());
+
+	UPsData* Target = Data.Get();
+	if (bAttached || !Target)
+	{
+		return;
+	}
+
+	bAttached = true;
+	PsDataTools::FPsDataFriend::SetJournal(Target, this);
+
+	if (!bSnapshot)
+	{
+		Compact();
+	}
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FPsDataJournal::Tick), FlushInterval);
+}
+
+void FPsDataJournal::Detach()
+{
+	if (!bAttached)
+	{
+		return;
+	}
+
+	Flush();
+
+	bAttached = false;
+	if (UPsData* Target = Data.Get())
+	{
+		PsDataTools::FPsDataFriend::SetJournal(Target, nullptr);
+	}
+
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+	TickerHandle.Reset();
+}
+
+bool FPsDataJournal::IsAttached() const
+{
+	return bAttached;
+}
+
+void FPsDataJournal::Flush()
+{
+	if (PendingRecords.Num() == 0)
+	{
+		return;
+	}
+
+	AppendBatch();
+
+	if (JournalSize > CompactionSize)
+	{
+		Compact();
+	}
+}
+
+void FPsDataJournal::AppendBatch()
+{
+	// Batch is written with its size and checksum, a torn batch is dropped on replay
+	FPsDataBufferOutputStream BatchHeader;
+	BatchHeader.WriteUint32(PendingRecords.Num());
+	BatchHeader.WriteUint32(FCrc::MemCrc32(PendingRecords.GetData(), PendingRecords.Num()));
+
+	JournalSize += BatchHeader.Size() + PendingRecords.Num();
+	Writer->Enqueue([JournalFilename = JournalFilename, Header = MoveTemp(BatchHeader.GetBuffer()), Bytes = MoveTemp(PendingRecords)]() {
+		if (!PsDataTools::WriteJournalFile(JournalFilename, Header, Bytes, true))
+		{
+			UE_LOG(LogData, Error, TEXT("Can't write journal \"%s\""), *JournalFilename);
+		}
+	});
+	PendingRecords.Reset();
+}
+
+void FPsDataJournal::Compact()
+{
+	check(IsInGameThread());
+
+	UPsData* Target = Data.Get();
+	if (!Target)
+	{
+		return;
+	}
+
+	// Recorded changes stay in the old journal until the new snapshot replaces it
+	if (PendingRecords.Num() > 0 && bSnapshot)
+	{
+		AppendBatch();
+	}
+	PendingRecords.Reset();
+
+	const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+	FPsDataBinarySerializer Serializer(OutputStream);
+	Target->DataSerialize(&Serializer);
+
+	bSnapshot = true;
+	JournalSize = PsDataTools::JournalHeaderSize;
+
+	// Journal is truncated in the same task only after the snapshot is replaced, the generation isn't advanced if it fails
+	Writer->Enqueue([Writer = Writer, Filename = Filename, JournalFilename = JournalFilename, Bytes = MoveTemp(OutputStream->GetBuffer())]() {
+		const uint32 NewGeneration = Writer->Generation + 1;
+		const FString TempFilename = Filename + TEXT(".tmp");
+		if (!PsDataTools::WriteJournalFile(TempFilename, PsDataTools::MakeJournalHeader(PsDataTools::JournalSnapshotMagic, NewGeneration), Bytes, false) ||
+			!PsDataTools::ReplaceJournalSnapshot(Filename, TempFilename))
+		{
+			UE_LOG(LogData, Error, TEXT("Can't write snapshot \"%s\", the journal is kept"), *Filename);
+			return;
+		}
+
+		Writer->Generation = NewGeneration;
+		if (!PsDataTools::WriteJournalFile(JournalFilename, PsDataTools::MakeJournalHeader(PsDataTools::JournalMagic, NewGeneration), {}, false))
+		{
+			UE_LOG(LogData, Error, TEXT("Can't write journal \"%s\""), *JournalFilename);
+		}
+	});
+}
+
+void FPsDataJournal::CommitChanges(const UPsData* Target, const FDataField* Field)
+{
+	if (bReplaying || Field->Context->IsData())
+	{
+		return;
+	}
+
+	const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+	FPsDataBinarySerializer Serializer(OutputStream);
+	Serializer.bWriteDefaults = false;
+	PsDataTools::FPsDataFriend::GetProperty(Target, Field->Index)->Serialize(&Serializer);
+
+	FString Path = Target->GetPathFromData(Data.Get());
+	if (Path.Len() > 0)
+	{
+		Path.AppendChar('.');
+	}
+	Path.Append(Field->Name);
+
+	AddRecord(ERecordType::Changed, Path, OutputStream->GetBuffer());
+}
+
+void FPsDataJournal::CommitAddedEvent(const UPsData* Target)
+{
+	if (bReplaying)
+	{
+		return;
+	}
+
+	const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+	FPsDataBinarySerializer Serializer(OutputStream);
+	Serializer.bWriteDefaults = false;
+	Target->DataSerialize(&Serializer);
+
+	AddRecord(ERecordType::Added, Target->GetPathFromData(Data.Get()), OutputStream->GetBuffer());
+}
+
+void FPsDataJournal::CommitRemovingEvent(const UPsData* Target)
+{
+	if (bReplaying)
+	{
+		return;
+	}
+
+	AddRecord(ERecordType::Removed, Target->GetPathFromData(Data.Get()), {});
+}
+
+void FPsDataJournal::AddRecord(ERecordType Type, const FString& Path, const TArray<uint8>& Buffer)
+{
+	FPsDataBufferOutputStream OutputStream;
+	OutputStream.GetBuffer() = MoveTemp(PendingRecords);
+	OutputStream.WriteUint8(static_cast<uint8>(Type));
+	OutputStream.WriteString(Path);
+	OutputStream.WriteUint32(Buffer.Num());
+	OutputStream.WriteBuffer(Buffer);
+	PendingRecords = MoveTemp(OutputStream.GetBuffer());
+}
+
+bool FPsDataJournal::Tick(float DeltaTime)
+{
+	Flush();
+	return true;
+}
+
+int32 FPsDataJournal::Replay(const TArray<uint8>& Buffer)
+{
+	int32 Position = PsDataTools::JournalHeaderSize;
+	while (Position + PsDataTools::JournalBatchHeaderSize <= Buffer.Num())
+	{
+		FPsDataViewInputStream BatchHeader(MakeArrayView(Buffer).Slice(Position, PsDataTools::JournalBatchHeaderSize));
+		const int32 Size = BatchHeader.ReadUint32();
+		const uint32 Crc = BatchHeader.ReadUint32();
+
+		const int32 BatchPosition = Position + PsDataTools::JournalBatchHeaderSize;
+		if (Size < 0 || Size > Buffer.Num() - BatchPosition || FCrc::MemCrc32(Buffer.GetData() + BatchPosition, Size) != Crc)
+		{
+			UE_LOG(LogData, Warning, TEXT("Journal \"%s\" is torn at %d"), *JournalFilename, Position);
+			break;
+		}
+
+		FPsDataViewInputStream InputStream(MakeArrayView(Buffer).Slice(BatchPosition, Size));
+		while (InputStream.GetPosition() < Size)
+		{
+			if (!ApplyRecord(InputStream))
+			{
+				UE_LOG(LogData, Warning, TEXT("Journal \"%s\" doesn't match the data at %d"), *JournalFilename, Position);
+				break;
+			}
+		}
+
+		Position = BatchPosition + Size;
+	}
+
+	return Position;
+}
+
+bool FPsDataJournal::ApplyRecord(FPsDataViewInputStream& InputStream)
+{
+	// Checksum doesn't protect from a journal written by another version, so the sizes are checked against the batch
+	if (!InputStream.CanRead(1))
+	{
+		return false;
+	}
+
+	const auto Type = static_cast<ERecordType>(InputStream.ReadUint8Unchecked());
+	FString Path;
+	if (!InputStream.TryReadString(Path) || !InputStream.CanRead(4))
+	{
+		return false;
+	}
+
+	const int32 Size = static_cast<int32>(InputStream.ReadUint32Unchecked());
+	if (!InputStream.CanRead(Size))
+	{
+		return false;
+	}
+
+	TArray<uint8> Buffer;
+	Buffer.SetNumUninitialized(Size);
+	InputStream.ReadBuffer(Buffer.GetData(), Size);
+
+	PsDataTools::TDataPathExecutor<false, false> PathExecutor(Data.Get(), Path);
+
+	FAbstractDataProperty* Property;
+	if (!PathExecutor.Execute(Property))
+	{
+		return false;
+	}
+
+	FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataViewInputStream>(Buffer));
+	switch (Type)
+	{
+	case ERecordType::Changed:
+		Property->Deserialize(&Deserializer);
+		return true;
+	case ERecordType::Added:
+		return ApplyAddedEvent(Property, PathExecutor.GetPath(), &Deserializer);
+	case ERecordType::Removed:
+		return ApplyRemovingEvent(Property, PathExecutor.GetPath());
+	default:
+		return false;
+	}
+}
+
+bool FPsDataJournal::ApplyAddedEvent(FAbstractDataProperty* Property, const FString& Key, FPsDataDeserializer* Deserializer) const
+{
+	const auto Field = Property->GetField();
+	if (!Field->Context->IsData())
+	{
+		return false;
+	}
+
+	UPsData* NewData = static_cast<UPsData*>(UPsDataUPsDataLibrary::TypeDeserialize(Property->GetOwner(), Field, Deserializer, nullptr));
+
+	if (Field->Context->IsArray())
+	{
+		const auto IndexOpt = PsDataTools::Numbers::ToUnsignedInteger<int32>(PsDataTools::ToStringView(Key));
+		if (PsDataTools::GetContext<TArray<UPsData*>>().IsA(Field->Context) && IndexOpt)
+		{
+			TPsDataArrayProxy<UPsData*> Proxy(static_cast<PsDataTools::TDataProperty<TArray<UPsData*>>*>(Property));
+			Proxy.Insert(NewData, IndexOpt.GetValue());
+			return true;
+		}
+	}
+	else if (Field->Context->IsMap())
+	{
+		if (PsDataTools::GetContext<TMap<FString, UPsData*>>().IsA(Field->Context) && PsDataTools::IsValidKey(Key))
+		{
+			TPsDataMapProxy<UPsData*> Proxy(static_cast<PsDataTools::TDataProperty<TMap<FString, UPsData*>>*>(Property));
+			if (!Proxy.Contains(Key))
+			{
+				Proxy.Add(Key, NewData);
+				return true;
+			}
+		}
+	}
+	else
+	{
+		static_cast<PsDataTools::TDataProperty<UPsData*>*>(Property)->SetValue(NewData);
+		return true;
+	}
+
+	return false;
+}
+
+bool FPsDataJournal::ApplyRemovingEvent(FAbstractDataProperty* Property, const FString& Key) const
+{
+	const auto Field = Property->GetField();
+	if (!Field->Context->IsData())
+	{
+		return false;
+	}
+
+	if (Field->Context->IsArray())
+	{
+		const auto IndexOpt = PsDataTools::Numbers::ToUnsignedInteger<int32>(PsDataTools::ToStringView(Key));
+		if (PsDataTools::GetContext<TArray<UPsData*>>().IsA(Field->Context) && IndexOpt)
+		{
+			TPsDataArrayProxy<UPsData*> Proxy(static_cast<PsDataTools::TDataProperty<TArray<UPsData*>>*>(Property));
+			if (Proxy.IsValidIndex(IndexOpt.GetValue()))
+			{
+				Proxy.RemoveAt(IndexOpt.GetValue());
+				return true;
+			}
+		}
+	}
+	else if (Field->Context->IsMap())
+	{
+		if (PsDataTools::GetContext<TMap<FString, UPsData*>>().IsA(Field->Context) && PsDataTools::IsValidKey(Key))
+		{
+			TPsDataMapProxy<UPsData*> Proxy(static_cast<PsDataTools::TDataProperty<TMap<FString, UPsData*>>*>(Property));
+			if (Proxy.Contains(Key))
+			{
+				Proxy.Remove(Key);
+				return true;
+			}
+		}
+	}
+	else
+	{
+		static_cast<PsDataTools::TDataProperty<UPsData*>*>(Property)->SetValue(nullptr);
+		return true;
+	}
+
+	return false;
+}
+
+void FPsDataJournal::ResetJournal()
+{
+	JournalSize = PsDataTools::JournalHeaderSize;
+	Writer->Enqueue([Writer = Writer, JournalFilename = JournalFilename]() {
+		if (!PsDataTools::WriteJournalFile(JournalFilename, PsDataTools::MakeJournalHeader(PsDataTools::JournalMagic, Writer->Generation), {}, false))
+		{
+			UE_LOG(LogData, Error, TEXT("Can't write journal \"%s\""), *JournalFilename);
+		}
+	});
+}
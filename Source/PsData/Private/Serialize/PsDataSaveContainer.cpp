@@ -0,0 +1,623 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/PsDataSaveContainer.h"
+
+#include "PsData.h"
+#include "PsDataCore.h"
+#include "Serialize/PsDataBinarySerialization.h"
+#include "Serialize/Stream/PsDataBufferOutputStream.h"
+#include "Serialize/Stream/PsDataMD5OutputStream.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
+
+#include "HAL/PlatformFilemanager.h"
+
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+constexpr uint32 SaveContainerMagic = 0x50534443; // PSDC
+constexpr uint32 SaveContainerVersion = 1;
+constexpr int32 SaveContainerHeaderSize = 8;
+constexpr int32 SaveContainerFooterSize = 12;
+
+/** Path length, offset, size, hash length and subtree flag */
+constexpr int32 SaveContainerMinEntrySize = 17;
+
+/** Single data property which value can be stored in its own block */
+bool IsSplitField(const FDataField* Field)
+{
+	return Field->Context->IsData() && !Field->Context->IsArray() && !Field->Context->IsMap() && !Field->Meta.bCustomType && !Field->Meta.bHidden;
+}
+
+UPsData* GetSplitChild(const UPsData* Data, const FDataField* Field)
+{
+	UPsData** ChildPtr = nullptr;
+	if (GetByField<false>(const_cast<UPsData*>(Data), Field, ChildPtr))
+	{
+		return *ChildPtr;
+	}
+	return nullptr;
+}
+
+bool ReadFileRange(IFileHandle& Handle, int64 Offset, int32 Size, TArray<uint8>& OutBytes)
+{
+	OutBytes.SetNumUninitialized(Size);
+	return Handle.Seek(Offset) && Handle.Read(OutBytes.GetData(), Size);
+}
+
+/** Complete temp file is renamed over the container, the container is only removed first where rename can't replace a file */
+bool ReplaceSaveContainerFile(IPlatformFile& PlatformFile, const FString& Filename, const FString& TempFilename)
+{
+	if (PlatformFile.MoveFile(*Filename, *TempFilename))
+	{
+		return true;
+	}
+
+	return PlatformFile.DeleteFile(*Filename) && PlatformFile.MoveFile(*Filename, *TempFilename);
+}
+} // namespace PsDataTools
+
+/***********************************
+ * FPsDataSaveContainer
+ ***********************************/
+
+FPsDataSaveContainer::FPsDataSaveContainer(const FString& InFilename, int32 InSplitDepth)
+	: CompactionRatio(1.f)
+	, Filename(InFilename)
+	, SplitDepth(FMath::Max(InSplitDepth, 1))
+	, FileSize(0)
+	, LiveSize(0)
+{
+}
+
+bool FPsDataSaveContainer::Open()
+{
+	Index.Reset();
+	FileSize = 0;
+	LiveSize = 0;
+
+	// Compaction was stopped after the container was removed, the temp file is complete at this point
+	auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempFilename = Filename + TEXT(".tmp");
+	if (!PlatformFile.FileExists(*Filename) && PlatformFile.FileExists(*TempFilename))
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" is restored from the compacted file"), *Filename);
+		PlatformFile.MoveFile(*Filename, *TempFilename);
+	}
+
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*Filename));
+	if (!Handle.IsValid())
+	{
+		return false;
+	}
+
+	const int64 Size = Handle->Size();
+	TArray<uint8> Header;
+	TArray<uint8> Footer;
+	if (Size < PsDataTools::SaveContainerHeaderSize + PsDataTools::SaveContainerFooterSize || Size > MAX_int32 ||
+		!PsDataTools::ReadFileRange(*Handle, 0, PsDataTools::SaveContainerHeaderSize, Header) ||
+		!PsDataTools::ReadFileRange(*Handle, Size - PsDataTools::SaveContainerFooterSize, PsDataTools::SaveContainerFooterSize, Footer))
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" is broken"), *Filename);
+		return false;
+	}
+
+	FPsDataViewInputStream HeaderStream(Header);
+	FPsDataViewInputStream FooterStream(Footer);
+	const uint32 HeaderMagic = HeaderStream.ReadUint32();
+	const uint32 Version = HeaderStream.ReadUint32();
+	const uint32 IndexOffset = FooterStream.ReadUint32();
+	const uint32 IndexSize = FooterStream.ReadUint32();
+	const uint32 FooterMagic = FooterStream.ReadUint32();
+	if (HeaderMagic != PsDataTools::SaveContainerMagic || FooterMagic != PsDataTools::SaveContainerMagic || Version != PsDataTools::SaveContainerVersion ||
+		static_cast<int64>(IndexOffset) + IndexSize + PsDataTools::SaveContainerFooterSize != Size)
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" is broken"), *Filename);
+		return false;
+	}
+
+	TArray<uint8> IndexBytes;
+	if (!PsDataTools::ReadFileRange(*Handle, IndexOffset, IndexSize, IndexBytes))
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" is broken"), *Filename);
+		return false;
+	}
+
+	// Entries can't take more than the index, and live blocks can't take more than the data before it
+	FPsDataViewInputStream IndexStream(IndexBytes);
+	const uint32 Num = IndexStream.CanRead(4) ? IndexStream.ReadUint32Unchecked() : MAX_uint32;
+	int64 TotalSize = 0;
+	bool bValid = Num <= IndexSize / PsDataTools::SaveContainerMinEntrySize;
+	for (uint32 i = 0; bValid && i < Num; ++i)
+	{
+		FString Path;
+		FEntry Entry;
+		bValid = ReadIndexEntry(IndexStream, IndexOffset, Path, Entry);
+		if (bValid)
+		{
+			TotalSize += Entry.Size;
+			bValid = TotalSize <= IndexOffset;
+			Index.Add(MoveTemp(Path), MoveTemp(Entry));
+		}
+	}
+
+	if (!bValid)
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" has broken index"), *Filename);
+		Index.Reset();
+		return false;
+	}
+
+	LiveSize = static_cast<int32>(TotalSize);
+	FileSize = static_cast<int32>(Size);
+	return true;
+}
+
+bool FPsDataSaveContainer::Save(const UPsData* Data)
+{
+	check(Data);
+
+	// Unchanged blocks of the existing file are kept, a broken file is rewritten as a whole
+	if (FileSize == 0)
+	{
+		Open();
+	}
+
+	TArray<FBlock> Blocks;
+	CollectBlocks(Data, Data, 0, Blocks);
+
+	TSet<FString> LivePaths;
+	for (auto& Block : Blocks)
+	{
+		HashBlock(Block);
+		LivePaths.Add(Block.Path);
+	}
+
+	return WriteBlocks(Blocks, LivePaths);
+}
+
+bool FPsDataSaveContainer::SaveBlock(const UPsData* Data, const FString& Path)
+{
+	check(Data);
+
+	// Block is appended to the existing file, other blocks would be lost if it was written as a new one
+	if (FileSize == 0 && !Open() && FPlatformFileManager::Get().GetPlatformFile().FileExists(*Filename))
+	{
+		UE_LOG(LogData, Error, TEXT("Can't write block \"%s\" into broken save container \"%s\""), *Path, *Filename);
+		return false;
+	}
+
+	TArray<FBlock> Blocks;
+	CollectBlocks(Data, Data, 0, Blocks);
+
+	const auto Block = Blocks.FindByPredicate([&Path](const FBlock& Item) {
+		return Item.Path == Path;
+	});
+
+	if (!Block)
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" has no block \"%s\""), *Filename, *Path);
+		return false;
+	}
+
+	TArray<FBlock> ChangedBlocks;
+	ChangedBlocks.Add(MoveTemp(*Block));
+	HashBlock(ChangedBlocks[0]);
+
+	TSet<FString> LivePaths;
+	Index.GetKeys(LivePaths);
+	LivePaths.Add(Path);
+
+	return WriteBlocks(ChangedBlocks, LivePaths);
+}
+
+bool FPsDataSaveContainer::Load(UPsData* Data)
+{
+	check(Data);
+
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+	if (!Handle.IsValid() || Index.Num() == 0)
+	{
+		UE_LOG(LogData, Warning, TEXT("Can't load save container \"%s\""), *Filename);
+		return false;
+	}
+
+	FPsDataEventScopeGuard EventGuard;
+	Data->Reset();
+
+	// Parent path is shorter than the paths of its children
+	TArray<FString> Paths = GetPaths();
+	Paths.Sort([](const FString& A, const FString& B) {
+		return A.Len() < B.Len();
+	});
+
+	bool bSuccess = true;
+	for (const auto& Path : Paths)
+	{
+		const auto& Entry = Index.FindChecked(Path);
+
+		TArray<uint8> Bytes;
+		bSuccess &= ReadBlock(*Handle, Entry, Bytes) && ApplyBlock(Data, Path, Entry, Bytes);
+	}
+
+	return bSuccess;
+}
+
+bool FPsDataSaveContainer::LoadBlock(UPsData* Data, const FString& Path)
+{
+	check(Data);
+
+	const auto Entry = Index.Find(Path);
+	if (!Entry)
+	{
+		UE_LOG(LogData, Warning, TEXT("Save container \"%s\" has no block \"%s\""), *Filename, *Path);
+		return false;
+	}
+
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Filename));
+	if (!Handle.IsValid())
+	{
+		UE_LOG(LogData, Warning, TEXT("Can't load save container \"%s\""), *Filename);
+		return false;
+	}
+
+	TArray<uint8> Bytes;
+	return ReadBlock(*Handle, *Entry, Bytes) && ApplyBlock(Data, Path, *Entry, Bytes);
+}
+
+bool FPsDataSaveContainer::Compact()
+{
+	auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempFilename = Filename + TEXT(".tmp");
+
+	TMap<FString, FEntry> NewIndex;
+	int32 NewFileSize = 0;
+	{
+		TUniquePtr<IFileHandle> ReadHandle(PlatformFile.OpenRead(*Filename));
+		TUniquePtr<IFileHandle> WriteHandle(PlatformFile.OpenWrite(*TempFilename));
+		if (!ReadHandle.IsValid() || !WriteHandle.IsValid())
+		{
+			UE_LOG(LogData, Error, TEXT("Can't compact save container \"%s\""), *Filename);
+			return false;
+		}
+
+		FPsDataBufferOutputStream Header;
+		Header.WriteUint32(PsDataTools::SaveContainerMagic);
+		Header.WriteUint32(PsDataTools::SaveContainerVersion);
+		bool bSuccess = WriteHandle->Write(Header.GetBuffer().GetData(), Header.Size());
+
+		uint32 Offset = Header.Size();
+		NewIndex.Reserve(Index.Num());
+		for (const auto& Pair : Index)
+		{
+			TArray<uint8> Bytes;
+			bSuccess = bSuccess && ReadBlock(*ReadHandle, Pair.Value, Bytes) && WriteHandle->Write(Bytes.GetData(), Bytes.Num());
+			if (!bSuccess)
+			{
+				break;
+			}
+
+			FEntry Entry = Pair.Value;
+			Entry.Offset = Offset;
+			Offset += Entry.Size;
+			NewIndex.Add(Pair.Key, Entry);
+		}
+
+		// Current index stays valid until the file is replaced
+		const auto IndexBytes = WriteIndex(NewIndex, Offset);
+
+		bSuccess = bSuccess && WriteHandle->Write(IndexBytes.GetData(), IndexBytes.Num()) && WriteHandle->Flush(true);
+		if (!bSuccess)
+		{
+			UE_LOG(LogData, Error, TEXT("Can't compact save container \"%s\""), *Filename);
+			WriteHandle.Reset();
+			PlatformFile.DeleteFile(*TempFilename);
+			return false;
+		}
+
+		NewFileSize = Offset + IndexBytes.Num();
+	}
+
+	if (!PsDataTools::ReplaceSaveContainerFile(PlatformFile, Filename, TempFilename))
+	{
+		UE_LOG(LogData, Error, TEXT("Can't replace save container \"%s\""), *Filename);
+		return false;
+	}
+
+	Index = MoveTemp(NewIndex);
+	FileSize = NewFileSize;
+	return true;
+}
+
+TArray<FString> FPsDataSaveContainer::GetPaths() const
+{
+	TArray<FString> Paths;
+	Index.GetKeys(Paths);
+	return Paths;
+}
+
+int32 FPsDataSaveContainer::GetGarbageSize() const
+{
+	if (FileSize == 0)
+	{
+		return 0;
+	}
+
+	// The last index is live as well
+	const int32 IndexSize = WriteIndex(Index, 0).Num();
+	return FileSize - PsDataTools::SaveContainerHeaderSize - LiveSize - IndexSize;
+}
+
+void FPsDataSaveContainer::CollectBlocks(const UPsData* Root, const UPsData* Data, int32 Depth, TArray<FBlock>& OutBlocks) const
+{
+	OutBlocks.Add({Data->GetPathFromData(Root), Data, nullptr});
+
+	for (const auto Field : PsDataTools::FDataReflection::GetFieldsByClass(Data->GetClass())->GetFieldsList())
+	{
+		if (!PsDataTools::IsSplitField(Field))
+		{
+			continue;
+		}
+
+		const UPsData* Child = PsDataTools::GetSplitChild(Data, Field);
+		if (!Child)
+		{
+			continue;
+		}
+
+		if (Depth + 1 < SplitDepth)
+		{
+			CollectBlocks(Root, Child, Depth + 1, OutBlocks);
+		}
+		else
+		{
+			OutBlocks.Add({Child->GetPathFromData(Root), Data, Field});
+		}
+	}
+}
+
+void FPsDataSaveContainer::HashBlock(FBlock& Block) const
+{
+	if (Block.Field)
+	{
+		// Hash of the subtree is cached by the data, so unchanged subtrees aren't serialized at all
+		Block.Hash = PsDataTools::GetSplitChild(Block.Data, Block.Field)->GetHash();
+		return;
+	}
+
+	SerializeBlock(Block);
+
+	FPsDataMD5OutputStream HashStream;
+	HashStream.WriteBuffer(Block.Bytes);
+	Block.Hash = HashStream.GetHash().ToString();
+}
+
+void FPsDataSaveContainer::SerializeBlock(FBlock& Block) const
+{
+	const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+	FPsDataBinarySerializer Serializer(OutputStream);
+
+	// Defaults are written so the block overwrites the data completely
+	Serializer.bWriteDefaults = true;
+
+	UPsData* Data = const_cast<UPsData*>(Block.Data);
+	if (Block.Field)
+	{
+		PsDataTools::FPsDataFriend::GetProperty(Data, Block.Field->Index)->Serialize(&Serializer);
+	}
+	else
+	{
+		Serializer.WriteObject();
+		for (const auto Property : PsDataTools::FPsDataFriend::GetProperties(Data))
+		{
+			const auto Field = Property->GetField();
+			if (Field->Meta.bHidden || (PsDataTools::IsSplitField(Field) && PsDataTools::GetSplitChild(Data, Field)))
+			{
+				continue;
+			}
+
+			const auto& Key = Field->GetNameForSerialize();
+			Serializer.WriteKey(Key);
+			Property->Serialize(&Serializer);
+			Serializer.PopKey(Key);
+		}
+		Serializer.PopObject();
+	}
+
+	Block.Bytes = MoveTemp(OutputStream->GetBuffer());
+}
+
+bool FPsDataSaveContainer::WriteBlocks(TArray<FBlock>& Blocks, const TSet<FString>& LivePaths)
+{
+	bool bChanged = false;
+	for (auto It = Index.CreateIterator(); It; ++It)
+	{
+		if (!LivePaths.Contains(It.Key()))
+		{
+			LiveSize -= It.Value().Size;
+			It.RemoveCurrent();
+			bChanged = true;
+		}
+	}
+
+	const bool bNewFile = FileSize == 0;
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename, !bNewFile));
+	if (!Handle.IsValid())
+	{
+		UE_LOG(LogData, Error, TEXT("Can't write save container \"%s\""), *Filename);
+		return false;
+	}
+
+	if (bNewFile)
+	{
+		FPsDataBufferOutputStream Header;
+		Header.WriteUint32(PsDataTools::SaveContainerMagic);
+		Header.WriteUint32(PsDataTools::SaveContainerVersion);
+		if (!Handle->Write(Header.GetBuffer().GetData(), Header.Size()))
+		{
+			UE_LOG(LogData, Error, TEXT("Can't write save container \"%s\""), *Filename);
+			return false;
+		}
+		FileSize = Header.Size();
+		bChanged = true;
+	}
+
+	for (auto& Block : Blocks)
+	{
+		const bool bSubtree = Block.Field != nullptr;
+		if (const auto Find = Index.Find(Block.Path))
+		{
+			if (Find->Hash == Block.Hash && Find->bSubtree == bSubtree)
+			{
+				continue;
+			}
+
+			LiveSize -= Find->Size;
+		}
+
+		if (bSubtree)
+		{
+			SerializeBlock(Block);
+		}
+
+		if (!Handle->Write(Block.Bytes.GetData(), Block.Bytes.Num()))
+		{
+			UE_LOG(LogData, Error, TEXT("Can't write save container \"%s\""), *Filename);
+			return false;
+		}
+
+		Index.Add(Block.Path, {static_cast<uint32>(FileSize), static_cast<uint32>(Block.Bytes.Num()), Block.Hash, bSubtree});
+		FileSize += Block.Bytes.Num();
+		LiveSize += Block.Bytes.Num();
+		bChanged = true;
+	}
+
+	if (!bChanged)
+	{
+		return true;
+	}
+
+	// Index of the file is the last one
+	const auto IndexBytes = WriteIndex(Index, FileSize);
+	if (!Handle->Write(IndexBytes.GetData(), IndexBytes.Num()))
+	{
+		UE_LOG(LogData, Error, TEXT("Can't write save container \"%s\""), *Filename);
+		return false;
+	}
+
+	FileSize += IndexBytes.Num();
+	Handle.Reset();
+
+	if (GetGarbageSize() > LiveSize * CompactionRatio)
+	{
+		return Compact();
+	}
+
+	return true;
+}
+
+bool FPsDataSaveContainer::ReadBlock(IFileHandle& Handle, const FEntry& Entry, TArray<uint8>& OutBytes) const
+{
+	if (!PsDataTools::ReadFileRange(Handle, Entry.Offset, Entry.Size, OutBytes))
+	{
+		UE_LOG(LogData, Warning, TEXT("Can't read block of save container \"%s\""), *Filename);
+		return false;
+	}
+	return true;
+}
+
+bool FPsDataSaveContainer::ApplyBlock(UPsData* Data, const FString& Path, const FEntry& Entry, const TArray<uint8>& Bytes) const
+{
+	TArray<FString> Keys;
+	Path.ParseIntoArray(Keys, TEXT("."));
+
+	// Data on the path is allocated if it's missing
+	UPsData* Target = Data;
+	const FDataField* Field = nullptr;
+	for (int32 i = 0; i < Keys.Num(); ++i)
+	{
+		Field = PsDataTools::FDataReflection::GetFieldsByClass(Target->GetClass())->GetFieldByName(Keys[i]);
+		if (!Field || !PsDataTools::IsSplitField(Field))
+		{
+			UE_LOG(LogData, Warning, TEXT("Block \"%s\" of save container \"%s\" doesn't match the data"), *Path, *Filename);
+			return false;
+		}
+
+		if (Entry.bSubtree && i == Keys.Num() - 1)
+		{
+			break;
+		}
+
+		UPsData* Child = PsDataTools::GetSplitChild(Target, Field);
+		if (!Child)
+		{
+			PsDataTools::FPsDataFriend::GetProperty(Target, Field->Index)->Allocate();
+			Child = PsDataTools::GetSplitChild(Target, Field);
+		}
+		Target = Child;
+	}
+
+	FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataViewInputStream>(Bytes));
+	if (Entry.bSubtree)
+	{
+		if (!Field)
+		{
+			UE_LOG(LogData, Warning, TEXT("Block \"%s\" of save container \"%s\" doesn't match the data"), *Path, *Filename);
+			return false;
+		}
+
+		PsDataTools::FPsDataFriend::GetProperty(Target, Field->Index)->Deserialize(&Deserializer);
+		return true;
+	}
+
+	if (!Deserializer.ReadObject())
+	{
+		UE_LOG(LogData, Warning, TEXT("Block \"%s\" of save container \"%s\" is broken"), *Path, *Filename);
+		return false;
+	}
+
+	PsDataTools::FPsDataFriend::Deserialize(Target, &Deserializer);
+	Deserializer.PopObject();
+	return true;
+}
+
+TArray<uint8> FPsDataSaveContainer::WriteIndex(const TMap<FString, FEntry>& Entries, uint32 IndexOffset)
+{
+	FPsDataBufferOutputStream OutputStream;
+	OutputStream.WriteUint32(Entries.Num());
+	for (const auto& Pair : Entries)
+	{
+		OutputStream.WriteString(Pair.Key);
+		OutputStream.WriteUint32(Pair.Value.Offset);
+		OutputStream.WriteUint32(Pair.Value.Size);
+		OutputStream.WriteString(Pair.Value.Hash);
+		OutputStream.WriteBool(Pair.Value.bSubtree);
+	}
+
+	const int32 IndexSize = OutputStream.Size();
+	OutputStream.WriteUint32(IndexOffset);
+	OutputStream.WriteUint32(IndexSize);
+	OutputStream.WriteUint32(PsDataTools::SaveContainerMagic);
+
+	return MoveTemp(OutputStream.GetBuffer());
+}
+
+bool FPsDataSaveContainer::ReadIndexEntry(FPsDataViewInputStream& Stream, uint32 IndexOffset, FString& OutPath, FEntry& OutEntry)
+{
+	if (!Stream.TryReadString(OutPath) || !Stream.CanRead(8))
+	{
+		return false;
+	}
+
+	OutEntry.Offset = Stream.ReadUint32Unchecked();
+	OutEntry.Size = Stream.ReadUint32Unchecked();
+	if (!Stream.TryReadString(OutEntry.Hash) || !Stream.CanRead(1))
+	{
+		return false;
+	}
+
+	OutEntry.bSubtree = Stream.ReadUint8Unchecked() == 0x01;
+	return OutEntry.Offset >= static_cast<uint32>(PsDataTools::SaveContainerHeaderSize) && static_cast<uint64>(OutEntry.Offset) + OutEntry.Size <= IndexOffset;
+}
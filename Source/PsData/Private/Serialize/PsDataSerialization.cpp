@@ -4,6 +4,48 @@
 
 #include "PsData.h"
 
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+template <typename T>
+void WriteValuesByElement(FPsDataSerializer* Serializer, const TArray<T>& Values)
+{
+	Serializer->WriteArray();
+	for (const T Value : Values)
+	{
+		Serializer->WriteValue(Value);
+	}
+	Serializer->PopArray();
+}
+
+template <typename T>
+bool ReadValuesByElement(FPsDataDeserializer* Deserializer, TArray<T>& OutValues)
+{
+	if (!Deserializer->ReadArray())
+	{
+		return false;
+	}
+
+	OutValues.Reset();
+	while (Deserializer->ReadIndex())
+	{
+		T Value = T();
+		if (!Deserializer->ReadValue(Value))
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't deserialize array element %d"), OutValues.Num());
+		}
+		OutValues.Add(Value);
+		Deserializer->PopIndex();
+	}
+	Deserializer->PopArray();
+
+	return true;
+}
+} // namespace PsDataTools
+
 /***********************************
  * FPsDataAllocator
  ***********************************/
@@ -48,10 +90,87 @@ FPsDataSerializer::FPsDataSerializer()
 {
 }
 
+void FPsDataSerializer::WriteValues(const TArray<int32>& Values)
+{
+	PsDataTools::WriteValuesByElement(this, Values);
+}
+
+void FPsDataSerializer::WriteValues(const TArray<int64>& Values)
+{
+	PsDataTools::WriteValuesByElement(this, Values);
+}
+
+void FPsDataSerializer::WriteValues(const TArray<uint8>& Values)
+{
+	PsDataTools::WriteValuesByElement(this, Values);
+}
+
+void FPsDataSerializer::WriteValues(const TArray<float>& Values)
+{
+	PsDataTools::WriteValuesByElement(this, Values);
+}
+
+void FPsDataSerializer::WriteValues(const TArray<bool>& Values)
+{
+	PsDataTools::WriteValuesByElement(this, Values);
+}
+
+void FPsDataSerializer::WriteDeleted()
+{
+	WriteValue(static_cast<const UPsData*>(nullptr));
+}
+
+bool FPsDataSerializer::WriteBinaryValue(const TArray<uint8>& Bytes)
+{
+	return false;
+}
+
 /***********************************
  * FPsDataDeserializer
  ***********************************/
 
 FPsDataDeserializer::FPsDataDeserializer()
+	: bParallelCollections(false)
+	, bPatch(false)
+{
+}
+
+bool FPsDataDeserializer::ReadValues(TArray<int32>& OutValues)
+{
+	return PsDataTools::ReadValuesByElement(this, OutValues);
+}
+
+bool FPsDataDeserializer::ReadValues(TArray<int64>& OutValues)
+{
+	return PsDataTools::ReadValuesByElement(this, OutValues);
+}
+
+bool FPsDataDeserializer::ReadValues(TArray<uint8>& OutValues)
+{
+	return PsDataTools::ReadValuesByElement(this, OutValues);
+}
+
+bool FPsDataDeserializer::ReadValues(TArray<float>& OutValues)
+{
+	return PsDataTools::ReadValuesByElement(this, OutValues);
+}
+
+bool FPsDataDeserializer::ReadValues(TArray<bool>& OutValues)
+{
+	return PsDataTools::ReadValuesByElement(this, OutValues);
+}
+
+bool FPsDataDeserializer::SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements)
+{
+	return false;
+}
+
+bool FPsDataDeserializer::ReadDeleted()
+{
+	return false;
+}
+
+TSharedPtr<const TArray<uint8>> FPsDataDeserializer::ReadBinaryValue()
 {
+	return nullptr;
 }
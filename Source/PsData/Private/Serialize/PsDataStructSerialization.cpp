@@ -4,83 +4,565 @@
 
 #include "PsData.h"
 #include "PsDataCore.h"
+#include "PsDataStruct.h"
 
 #include "Internationalization/Regex.h"
 #include "JsonObjectConverter.h"
 #include "UObject/TextProperty.h"
 
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+const FProperty* FindStructPropertyByKey(const UStruct* Struct, const FString& Key)
+{
+	if (const auto DataStruct = Cast<UPsDataStruct>(Struct))
+	{
+		return DataStruct->FindPropertyByKey(Key);
+	}
+
+	return Struct->FindPropertyByName(*Key);
+}
+
+const UEnum* GetPropertyEnum(const FProperty* Property)
+{
+	if (const auto EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		return EnumProperty->GetEnum();
+	}
+
+	if (const auto ByteProperty = CastField<FByteProperty>(Property))
+	{
+		return ByteProperty->Enum;
+	}
+
+	return nullptr;
+}
+
+const FNumericProperty* GetPropertyNumeric(const FProperty* Property)
+{
+	if (const auto EnumProperty = CastField<FEnumProperty>(Property))
+	{
+		return EnumProperty->GetUnderlyingProperty();
+	}
+
+	return CastField<FNumericProperty>(Property);
+}
+
+bool SetPropertyNumber(const FProperty* Property, uint8* Ptr, int64 Value)
+{
+	if (const auto NumericProperty = GetPropertyNumeric(Property))
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			NumericProperty->SetFloatingPointPropertyValue(Ptr, static_cast<double>(Value));
+		}
+		else
+		{
+			NumericProperty->SetIntPropertyValue(Ptr, Value);
+		}
+		return true;
+	}
+
+	if (const auto BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		BoolProperty->SetPropertyValue(Ptr, Value != 0);
+		return true;
+	}
+
+	return false;
+}
+
+bool SetPropertyNumber(const FProperty* Property, uint8* Ptr, double Value)
+{
+	if (const auto NumericProperty = GetPropertyNumeric(Property))
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			NumericProperty->SetFloatingPointPropertyValue(Ptr, Value);
+		}
+		else
+		{
+			NumericProperty->SetIntPropertyValue(Ptr, static_cast<int64>(Value));
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool SetPropertyString(const FProperty* Property, uint8* Ptr, const FString& Value)
+{
+	if (const auto StrProperty = CastField<FStrProperty>(Property))
+	{
+		StrProperty->SetPropertyValue(Ptr, Value);
+		return true;
+	}
+
+	if (const auto NameProperty = CastField<FNameProperty>(Property))
+	{
+		NameProperty->SetPropertyValue(Ptr, FName(*Value));
+		return true;
+	}
+
+	if (const auto TextProperty = CastField<FTextProperty>(Property))
+	{
+		FText Text = FText::GetEmpty();
+		FTextStringHelper::ReadFromBuffer(*Value, Text);
+		TextProperty->SetPropertyValue(Ptr, Text);
+		return true;
+	}
+
+	if (const auto SoftObjectProperty = CastField<FSoftObjectProperty>(Property))
+	{
+		SoftObjectProperty->SetPropertyValue(Ptr, FSoftObjectPtr(FSoftObjectPath(Value)));
+		return true;
+	}
+
+	if (const auto Enum = GetPropertyEnum(Property))
+	{
+		const int64 EnumValue = Enum->GetValueByNameString(Value);
+		return EnumValue != INDEX_NONE && SetPropertyNumber(Property, Ptr, EnumValue);
+	}
+
+	return Property->ImportText(*Value, Ptr, PPF_None, nullptr) != nullptr;
+}
+
+bool GetPropertyNumber(const FProperty* Property, const uint8* Ptr, int64& OutValue)
+{
+	if (const auto NumericProperty = GetPropertyNumeric(Property))
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			OutValue = static_cast<int64>(NumericProperty->GetFloatingPointPropertyValue(Ptr));
+		}
+		else
+		{
+			OutValue = NumericProperty->GetSignedIntPropertyValue(Ptr);
+		}
+		return true;
+	}
+
+	if (const auto BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		OutValue = BoolProperty->GetPropertyValue(Ptr) ? 1 : 0;
+		return true;
+	}
+
+	return false;
+}
+
+bool GetPropertyNumber(const FProperty* Property, const uint8* Ptr, double& OutValue)
+{
+	if (const auto NumericProperty = GetPropertyNumeric(Property))
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			OutValue = NumericProperty->GetFloatingPointPropertyValue(Ptr);
+		}
+		else
+		{
+			OutValue = static_cast<double>(NumericProperty->GetSignedIntPropertyValue(Ptr));
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool GetPropertyString(const FProperty* Property, const uint8* Ptr, FString& OutValue)
+{
+	if (const auto StrProperty = CastField<FStrProperty>(Property))
+	{
+		OutValue = StrProperty->GetPropertyValue(Ptr);
+		return true;
+	}
+
+	if (const auto NameProperty = CastField<FNameProperty>(Property))
+	{
+		OutValue = NameProperty->GetPropertyValue(Ptr).ToString();
+		return true;
+	}
+
+	if (const auto TextProperty = CastField<FTextProperty>(Property))
+	{
+		OutValue.Reset();
+		FTextStringHelper::WriteToBuffer(OutValue, TextProperty->GetPropertyValue(Ptr));
+		return true;
+	}
+
+	if (const auto SoftObjectProperty = CastField<FSoftObjectProperty>(Property))
+	{
+		OutValue = SoftObjectProperty->GetPropertyValue(Ptr).ToString();
+		return true;
+	}
+
+	if (const auto Enum = GetPropertyEnum(Property))
+	{
+		int64 EnumValue = 0;
+		if (GetPropertyNumber(Property, Ptr, EnumValue))
+		{
+			OutValue = Enum->GetNameStringByValue(EnumValue);
+			return !OutValue.IsEmpty();
+		}
+		return false;
+	}
+
+	if (Property->IsA<FStructProperty>())
+	{
+		OutValue.Reset();
+		Property->ExportTextItem(OutValue, Ptr, nullptr, nullptr, PPF_None);
+		return true;
+	}
+
+	return false;
+}
+} // namespace PsDataTools
+
 /***********************************
  * FPsDataStructSerializer
  ***********************************/
 
+FPsDataStructSerializer::FPsDataStructSerializer(const UStruct* InStruct, bool bInitialize)
+	: FPsDataSerializer()
+	, Struct(InStruct)
+	, Raw(static_cast<uint8*>(FMemory::Malloc(InStruct->GetStructureSize(), InStruct->GetMinAlignment())))
+	, bOwnRaw(true)
+{
+	bWriteDefaults = true;
+
+	if (bInitialize)
+	{
+		Struct->InitializeStruct(Raw);
+	}
+	else
+	{
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			It->InitializeValue_InContainer(Raw);
+		}
+	}
+}
+
+FPsDataStructSerializer::FPsDataStructSerializer(TSharedPtr<FJsonObject> InRootJson)
+	: FPsDataSerializer()
+	, Struct(nullptr)
+	, Raw(nullptr)
+	, bOwnRaw(false)
+	, LegacyJson(MakeUnique<FPsDataJsonSerializer>(InRootJson))
+{
+	LegacyJson->bWriteDefaults = true;
+	bWriteDefaults = true;
+}
+
+FPsDataStructSerializer::FPsDataStructSerializer()
+	: FPsDataSerializer()
+	, Struct(nullptr)
+	, Raw(nullptr)
+	, bOwnRaw(false)
+	, LegacyJson(MakeUnique<FPsDataJsonSerializer>())
+{
+	LegacyJson->bWriteDefaults = true;
+	bWriteDefaults = true;
+}
+
+FPsDataStructSerializer::~FPsDataStructSerializer()
+{
+	if (bOwnRaw)
+	{
+		Struct->DestroyStruct(Raw);
+		FMemory::Free(Raw);
+	}
+}
+
+uint8* FPsDataStructSerializer::GetRaw()
+{
+	check(bOwnRaw);
+	bOwnRaw = false;
+	return Raw;
+}
+
+uint8* FPsDataStructSerializer::GetRaw(UStruct* InStruct, bool bInitialize)
+{
+	return GetLegacyRaw(InStruct, bInitialize);
+}
+
+uint8* FPsDataStructSerializer::GetLegacyRaw(const UStruct* InStruct, bool bInitialize) const
+{
+	check(LegacyJson.IsValid());
+	return CreateStructFromJson(InStruct, LegacyJson->GetJson().ToSharedRef(), bInitialize);
+}
+
+FPsDataStructSerializer::FFrame FPsDataStructSerializer::TakeValueFrame()
+{
+	check(Stack.Num() > 0);
+	const auto& Frame = Stack.Last();
+	if (Frame.Type == EFrameType::Array)
+	{
+		const auto ArrayProperty = CastFieldChecked<FArrayProperty>(Frame.Property);
+		FScriptArrayHelper ScriptArrayHelper(ArrayProperty, Frame.Ptr);
+		const int32 Index = ScriptArrayHelper.AddValue();
+		return {EFrameType::Value, ArrayProperty->Inner, nullptr, ScriptArrayHelper.GetRawPtr(Index)};
+	}
+
+	check(Frame.Type == EFrameType::Value || Frame.Type == EFrameType::Skip);
+	return Frame;
+}
+
 void FPsDataStructSerializer::WriteKey(const FString& Key)
 {
-	JsonSerializer.WriteKey(Key);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteKey(Key);
+		return;
+	}
+
+	check(Stack.Num() > 0);
+	const auto& Frame = Stack.Last();
+	if (Frame.Type == EFrameType::Object)
+	{
+		if (const auto Property = PsDataTools::FindStructPropertyByKey(Frame.Struct, Key))
+		{
+			Stack.Push({EFrameType::Value, Property, nullptr, Property->ContainerPtrToValuePtr<uint8>(Frame.Ptr)});
+			return;
+		}
+	}
+	else if (Frame.Type == EFrameType::Map)
+	{
+		const auto MapProperty = CastFieldChecked<FMapProperty>(Frame.Property);
+		FScriptMapHelper ScriptMapHelper(MapProperty, Frame.Ptr);
+		const int32 Index = ScriptMapHelper.AddDefaultValue_Invalid_NeedsRehash();
+		if (!PsDataTools::SetPropertyString(MapProperty->KeyProp, ScriptMapHelper.GetKeyPtr(Index), Key))
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't serialize key \"%s\" as \"%s\""), *Key, *MapProperty->KeyProp->GetCPPType());
+		}
+
+		Stack.Push({EFrameType::Value, MapProperty->ValueProp, nullptr, ScriptMapHelper.GetValuePtr(Index)});
+		return;
+	}
+
+	Stack.Push({EFrameType::Skip, nullptr, nullptr, nullptr});
 }
 
 void FPsDataStructSerializer::WriteArray()
 {
-	JsonSerializer.WriteArray();
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteArray();
+		return;
+	}
+
+	const auto Frame = TakeValueFrame();
+	if (Frame.Type == EFrameType::Value && Frame.Property->IsA<FArrayProperty>())
+	{
+		Stack.Push({EFrameType::Array, Frame.Property, nullptr, Frame.Ptr});
+	}
+	else
+	{
+		Stack.Push({EFrameType::Skip, nullptr, nullptr, nullptr});
+	}
 }
 
 void FPsDataStructSerializer::WriteObject()
 {
-	JsonSerializer.WriteObject();
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteObject();
+		return;
+	}
+
+	if (Stack.Num() == 0)
+	{
+		Stack.Push({EFrameType::Object, nullptr, Struct, Raw});
+		return;
+	}
+
+	const auto Frame = TakeValueFrame();
+	if (Frame.Type == EFrameType::Value)
+	{
+		if (const auto StructProperty = CastField<FStructProperty>(Frame.Property))
+		{
+			Stack.Push({EFrameType::Object, StructProperty, StructProperty->Struct, Frame.Ptr});
+			return;
+		}
+
+		if (Frame.Property->IsA<FMapProperty>())
+		{
+			Stack.Push({EFrameType::Map, Frame.Property, nullptr, Frame.Ptr});
+			return;
+		}
+
+		UE_LOG(LogData, Warning, TEXT("Can't serialize object as \"%s\""), *Frame.Property->GetCPPType());
+	}
+
+	Stack.Push({EFrameType::Skip, nullptr, nullptr, nullptr});
 }
 
 void FPsDataStructSerializer::WriteValue(int32 Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	WriteValue(static_cast<int64>(Value));
 }
 
 void FPsDataStructSerializer::WriteValue(int64 Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	const auto Frame = TakeValueFrame();
+	if (Frame.Type == EFrameType::Value && !PsDataTools::SetPropertyNumber(Frame.Property, Frame.Ptr, Value))
+	{
+		UE_LOG(LogData, Warning, TEXT("Can't serialize number as \"%s\""), *Frame.Property->GetCPPType());
+	}
 }
 
 void FPsDataStructSerializer::WriteValue(uint8 Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	WriteValue(static_cast<int64>(Value));
 }
 
 void FPsDataStructSerializer::WriteValue(float Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	const auto Frame = TakeValueFrame();
+	if (Frame.Type == EFrameType::Value && !PsDataTools::SetPropertyNumber(Frame.Property, Frame.Ptr, static_cast<double>(Value)))
+	{
+		UE_LOG(LogData, Warning, TEXT("Can't serialize number as \"%s\""), *Frame.Property->GetCPPType());
+	}
 }
 
 void FPsDataStructSerializer::WriteValue(bool Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	WriteValue(static_cast<int64>(Value ? 1 : 0));
 }
 
 void FPsDataStructSerializer::WriteValue(const FString& Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	const auto Frame = TakeValueFrame();
+	if (Frame.Type == EFrameType::Value && !PsDataTools::SetPropertyString(Frame.Property, Frame.Ptr, Value))
+	{
+		UE_LOG(LogData, Warning, TEXT("Can't serialize \"%s\" as \"%s\""), *Value, *Frame.Property->GetCPPType());
+	}
 }
 
 void FPsDataStructSerializer::WriteValue(const FName& Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	const auto Frame = TakeValueFrame();
+	if (Frame.Type == EFrameType::Value)
+	{
+		if (const auto NameProperty = CastField<FNameProperty>(Frame.Property))
+		{
+			NameProperty->SetPropertyValue(Frame.Ptr, Value);
+		}
+		else if (!PsDataTools::SetPropertyString(Frame.Property, Frame.Ptr, Value.ToString()))
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't serialize \"%s\" as \"%s\""), *Value.ToString(), *Frame.Property->GetCPPType());
+		}
+	}
 }
 
 void FPsDataStructSerializer::WriteValue(const UPsData* Value)
 {
-	JsonSerializer.WriteValue(Value);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->WriteValue(Value);
+		return;
+	}
+
+	if (Value == nullptr)
+	{
+		TakeValueFrame();
+	}
+	else
+	{
+		WriteObject();
+		PsDataTools::FPsDataFriend::Serialize(Value, this);
+		PopObject();
+	}
 }
 
 void FPsDataStructSerializer::PopKey(const FString& Key)
 {
-	JsonSerializer.PopKey(Key);
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->PopKey(Key);
+		return;
+	}
+
+	check(Stack.Num() > 0 && (Stack.Last().Type == EFrameType::Value || Stack.Last().Type == EFrameType::Skip));
+	Stack.Pop(false);
 }
 
 void FPsDataStructSerializer::PopArray()
 {
-	JsonSerializer.PopArray();
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->PopArray();
+		return;
+	}
+
+	check(Stack.Num() > 0 && (Stack.Last().Type == EFrameType::Array || Stack.Last().Type == EFrameType::Skip));
+	Stack.Pop(false);
 }
 
 void FPsDataStructSerializer::PopObject()
 {
-	JsonSerializer.PopObject();
+	if (LegacyJson.IsValid())
+	{
+		LegacyJson->PopObject();
+		return;
+	}
+
+	check(Stack.Num() > 0);
+	const auto Frame = Stack.Pop(false);
+	if (Frame.Type == EFrameType::Map)
+	{
+		FScriptMapHelper ScriptMapHelper(CastFieldChecked<FMapProperty>(Frame.Property), Frame.Ptr);
+		ScriptMapHelper.Rehash();
+	}
+	else
+	{
+		check(Frame.Type == EFrameType::Object || Frame.Type == EFrameType::Skip);
+	}
 }
 
 /***********************************
@@ -96,10 +578,52 @@ uint8* FPsDataStructSerializer::CreateStructFromJson(const UStruct* Struct, cons
 
 uint8* FPsDataStructSerializer::CreateStructFromJson_Import(const UStruct* Struct, const TSharedRef<FJsonObject>& JsonObject, TArray<FString>& ImportProblems)
 {
-	return CreateStructFromJson(Struct, JsonObject, true);
+	uint8* Dest = static_cast<uint8*>(FMemory::Malloc(Struct->GetStructureSize()));
+	if (!StructDeserialize(Struct, Dest, JsonObject, true))
+	{
+		ImportProblems.Add(FString::Printf(TEXT("Some properties of struct '%s' can't be converted, see the log for details."), *Struct->GetName()));
+	}
+	return Dest;
+}
+
+bool FPsDataStructSerializer::IsPlainStruct(const UStruct* Struct)
+{
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		if (!IsPlainProperty(*It))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FPsDataStructSerializer::IsPlainProperty(const FProperty* Property)
+{
+	if (Property->IsA<FNumericProperty>() || Property->IsA<FBoolProperty>() || Property->IsA<FEnumProperty>() || Property->IsA<FStrProperty>() || Property->IsA<FNameProperty>())
+	{
+		return true;
+	}
+
+	if (const auto StructProperty = CastField<FStructProperty>(Property))
+	{
+		return IsPlainStruct(StructProperty->Struct);
+	}
+
+	if (const auto ArrayProperty = CastField<FArrayProperty>(Property))
+	{
+		return IsPlainProperty(ArrayProperty->Inner);
+	}
+
+	if (const auto MapProperty = CastField<FMapProperty>(Property))
+	{
+		return IsPlainProperty(MapProperty->KeyProp) && IsPlainProperty(MapProperty->ValueProp);
+	}
+
+	return false;
 }
 
-void FPsDataStructSerializer::PropertyDeserialize(FProperty* Property, uint8* OutDest, const TSharedRef<FJsonValue>& JsonValue)
+bool FPsDataStructSerializer::PropertyDeserialize(FProperty* Property, uint8* OutDest, const TSharedRef<FJsonValue>& JsonValue)
 {
 	if (const auto TextProperty = CastField<FTextProperty>(Property))
 	{
@@ -108,7 +632,7 @@ void FPsDataStructSerializer::PropertyDeserialize(FProperty* Property, uint8* Ou
 			FText Text = FText::GetEmpty();
 			FTextStringHelper::ReadFromBuffer(*JsonValue->AsString(), Text);
 			TextProperty->SetPropertyValue(OutDest, Text);
-			return;
+			return true;
 		}
 
 		UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s\" as \"%s\""), *Property->GetAuthoredName(), *TextProperty->GetCPPType());
@@ -118,7 +642,7 @@ void FPsDataStructSerializer::PropertyDeserialize(FProperty* Property, uint8* Ou
 		if (JsonValue->Type == EJson::String)
 		{
 			SoftClassProperty->SetPropertyValue(OutDest, FSoftObjectPtr(FSoftClassPath(JsonValue->AsString())));
-			return;
+			return true;
 		}
 
 		UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s\" as \"%s\""), *Property->GetAuthoredName(), *SoftClassProperty->GetCPPType(nullptr, 0));
@@ -128,7 +652,7 @@ void FPsDataStructSerializer::PropertyDeserialize(FProperty* Property, uint8* Ou
 		if (JsonValue->Type == EJson::String)
 		{
 			SoftObjectProperty->SetPropertyValue(OutDest, FSoftObjectPtr(FSoftObjectPath(JsonValue->AsString())));
-			return;
+			return true;
 		}
 
 		UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s\" as \"%s\""), *Property->GetAuthoredName(), *SoftObjectProperty->GetCPPType(nullptr, 0));
@@ -137,23 +661,23 @@ void FPsDataStructSerializer::PropertyDeserialize(FProperty* Property, uint8* Ou
 	{
 		if (JsonValue->Type == EJson::Object)
 		{
-			StructDeserialize(StructProperty->Struct, OutDest, JsonValue->AsObject().ToSharedRef(), true);
-			return;
+			return StructDeserialize(StructProperty->Struct, OutDest, JsonValue->AsObject().ToSharedRef(), true);
 		}
 
 		UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s\" as \"%s\""), *Property->GetAuthoredName(), *StructProperty->GetCPPType(nullptr, 0));
 	}
 
-	FJsonObjectConverter::JsonValueToUProperty(JsonValue, Property, OutDest, 0, 0);
+	return FJsonObjectConverter::JsonValueToUProperty(JsonValue, Property, OutDest, 0, 0);
 }
 
-void FPsDataStructSerializer::StructDeserialize(const UStruct* Struct, uint8* OutDest, const TSharedRef<FJsonObject>& JsonObject, bool bInitialize)
+bool FPsDataStructSerializer::StructDeserialize(const UStruct* Struct, uint8* OutDest, const TSharedRef<FJsonObject>& JsonObject, bool bInitialize)
 {
 	if (bInitialize)
 	{
 		Struct->InitializeStruct(OutDest);
 	}
 
+	bool bResult = true;
 	for (TFieldIterator<FProperty> It(Struct); It; ++It)
 	{
 		FProperty* Property = *It;
@@ -174,13 +698,14 @@ void FPsDataStructSerializer::StructDeserialize(const UStruct* Struct, uint8* Ou
 						ScriptArrayHelper.AddValues(JsonArray.Num());
 						for (int32 i = 0; i < JsonArray.Num(); ++i)
 						{
-							PropertyDeserialize(ArrayProperty->Inner, ScriptArrayHelper.GetRawPtr(i), JsonArray[i].ToSharedRef());
+							bResult &= PropertyDeserialize(ArrayProperty->Inner, ScriptArrayHelper.GetRawPtr(i), JsonArray[i].ToSharedRef());
 						}
 					}
 				}
 				else
 				{
 					UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s\" as \"%s\""), *Property->GetAuthoredName(), *ArrayProperty->GetCPPType(nullptr, 0));
+					bResult = false;
 				}
 			}
 			else if (const auto MapProperty = CastField<FMapProperty>(Property))
@@ -192,21 +717,24 @@ void FPsDataStructSerializer::StructDeserialize(const UStruct* Struct, uint8* Ou
 					for (auto& Pair : JsonMap->Values)
 					{
 						const auto Index = ScriptMapHelper.AddDefaultValue_Invalid_NeedsRehash();
-						PropertyDeserialize(MapProperty->KeyProp, ScriptMapHelper.GetKeyPtr(Index), MakeShared<FJsonValueString>(Pair.Key));
-						PropertyDeserialize(MapProperty->ValueProp, ScriptMapHelper.GetValuePtr(Index), Pair.Value.ToSharedRef());
+						bResult &= PropertyDeserialize(MapProperty->KeyProp, ScriptMapHelper.GetKeyPtr(Index), MakeShared<FJsonValueString>(Pair.Key));
+						bResult &= PropertyDeserialize(MapProperty->ValueProp, ScriptMapHelper.GetValuePtr(Index), Pair.Value.ToSharedRef());
 					}
 				}
 				else
 				{
 					UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s\" as \"%s\""), *Property->GetAuthoredName(), *MapProperty->GetCPPType(nullptr, 0));
+					bResult = false;
 				}
 			}
 			else
 			{
-				PropertyDeserialize(Property, ValueDest, JsonValue.ToSharedRef());
+				bResult &= PropertyDeserialize(Property, ValueDest, JsonValue.ToSharedRef());
 			}
 		}
 	}
+
+	return bResult;
 }
 
 TSharedPtr<FJsonValue> FPsDataStructSerializer::FindJsonValueByProperty(const FProperty* Property, const TSharedRef<FJsonObject>& JsonObject)
@@ -223,84 +751,272 @@ TSharedPtr<FJsonValue> FPsDataStructSerializer::FindJsonValueByProperty(const FP
  * FPsDataStructDeserializer
  ***********************************/
 
+FPsDataStructDeserializer::FPsDataStructDeserializer(const UStruct* InStruct, const void* Value)
+	: FPsDataDeserializer()
+	, Struct(InStruct)
+	, Raw(static_cast<const uint8*>(Value))
+{
+	check(Struct && Raw);
+}
+
+bool FPsDataStructDeserializer::GetCurrentValue(const FProperty*& OutProperty, const uint8*& OutPtr) const
+{
+	check(Stack.Num() > 0);
+	const auto& Frame = Stack.Last();
+	if (Frame.Type == EFrameType::Object)
+	{
+		if (Frame.Current)
+		{
+			OutProperty = Frame.Current;
+			OutPtr = Frame.Current->ContainerPtrToValuePtr<uint8>(Frame.Ptr);
+			return true;
+		}
+	}
+	else if (Frame.Type == EFrameType::Array)
+	{
+		const auto ArrayProperty = CastFieldChecked<FArrayProperty>(Frame.Property);
+		FScriptArrayHelper ScriptArrayHelper(ArrayProperty, Frame.Ptr);
+		if (ScriptArrayHelper.IsValidIndex(Frame.Index))
+		{
+			OutProperty = ArrayProperty->Inner;
+			OutPtr = ScriptArrayHelper.GetRawPtr(Frame.Index);
+			return true;
+		}
+	}
+	else if (Frame.Type == EFrameType::Map)
+	{
+		const auto MapProperty = CastFieldChecked<FMapProperty>(Frame.Property);
+		FScriptMapHelper ScriptMapHelper(MapProperty, Frame.Ptr);
+		if (ScriptMapHelper.IsValidIndex(Frame.Index))
+		{
+			OutProperty = MapProperty->ValueProp;
+			OutPtr = ScriptMapHelper.GetValuePtr(Frame.Index);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool FPsDataStructDeserializer::ReadKey(FString& OutKey)
 {
-	return JsonDeserializer.ReadKey(OutKey);
+	check(Stack.Num() > 0);
+	auto& Frame = Stack.Last();
+	if (Frame.Type == EFrameType::Object)
+	{
+		if (Frame.Current)
+		{
+			OutKey = Frame.Current->GetAuthoredName();
+			return true;
+		}
+	}
+	else if (Frame.Type == EFrameType::Map)
+	{
+		const auto MapProperty = CastFieldChecked<FMapProperty>(Frame.Property);
+		FScriptMapHelper ScriptMapHelper(MapProperty, Frame.Ptr);
+		while (Frame.Index < ScriptMapHelper.GetMaxIndex() && !ScriptMapHelper.IsValidIndex(Frame.Index))
+		{
+			++Frame.Index;
+		}
+
+		if (ScriptMapHelper.IsValidIndex(Frame.Index))
+		{
+			return PsDataTools::GetPropertyString(MapProperty->KeyProp, ScriptMapHelper.GetKeyPtr(Frame.Index), OutKey);
+		}
+	}
+	else
+	{
+		checkNoEntry();
+	}
+
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadIndex()
 {
-	return JsonDeserializer.ReadIndex();
+	check(Stack.Num() > 0 && Stack.Last().Type == EFrameType::Array);
+	const auto& Frame = Stack.Last();
+	FScriptArrayHelper ScriptArrayHelper(CastFieldChecked<FArrayProperty>(Frame.Property), Frame.Ptr);
+	return ScriptArrayHelper.IsValidIndex(Frame.Index);
 }
 
 bool FPsDataStructDeserializer::ReadArray()
 {
-	return JsonDeserializer.ReadArray();
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	if (GetCurrentValue(Property, Ptr) && Property->IsA<FArrayProperty>())
+	{
+		Stack.Push({EFrameType::Array, Property, nullptr, Ptr, 0});
+		return true;
+	}
+
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadObject()
 {
-	return JsonDeserializer.ReadObject();
+	if (Stack.Num() == 0)
+	{
+		Stack.Push({EFrameType::Object, nullptr, Struct->PropertyLink, Raw, 0});
+		return true;
+	}
+
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	if (GetCurrentValue(Property, Ptr))
+	{
+		if (const auto StructProperty = CastField<FStructProperty>(Property))
+		{
+			Stack.Push({EFrameType::Object, StructProperty, StructProperty->Struct->PropertyLink, Ptr, 0});
+			return true;
+		}
+
+		if (Property->IsA<FMapProperty>())
+		{
+			Stack.Push({EFrameType::Map, Property, nullptr, Ptr, 0});
+			return true;
+		}
+	}
+
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadValue(int32& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	int64 Value = 0;
+	if (ReadValue(Value))
+	{
+		OutValue = static_cast<int32>(Value);
+		return true;
+	}
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadValue(int64& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	return GetCurrentValue(Property, Ptr) && PsDataTools::GetPropertyNumber(Property, Ptr, OutValue);
 }
 
 bool FPsDataStructDeserializer::ReadValue(uint8& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	int64 Value = 0;
+	if (ReadValue(Value))
+	{
+		OutValue = static_cast<uint8>(Value);
+		return true;
+	}
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadValue(float& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	double Value = 0;
+	if (GetCurrentValue(Property, Ptr) && PsDataTools::GetPropertyNumber(Property, Ptr, Value))
+	{
+		OutValue = static_cast<float>(Value);
+		return true;
+	}
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadValue(bool& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	if (GetCurrentValue(Property, Ptr))
+	{
+		if (const auto BoolProperty = CastField<FBoolProperty>(Property))
+		{
+			OutValue = BoolProperty->GetPropertyValue(Ptr);
+			return true;
+		}
+	}
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadValue(FString& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	return GetCurrentValue(Property, Ptr) && PsDataTools::GetPropertyString(Property, Ptr, OutValue);
 }
 
 bool FPsDataStructDeserializer::ReadValue(FName& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	const FProperty* Property = nullptr;
+	const uint8* Ptr = nullptr;
+	if (GetCurrentValue(Property, Ptr))
+	{
+		if (const auto NameProperty = CastField<FNameProperty>(Property))
+		{
+			OutValue = NameProperty->GetPropertyValue(Ptr);
+			return true;
+		}
+
+		FString Value;
+		if (PsDataTools::GetPropertyString(Property, Ptr, Value))
+		{
+			OutValue = FName(*Value);
+			return true;
+		}
+	}
+	return false;
 }
 
 bool FPsDataStructDeserializer::ReadValue(UPsData*& OutValue, FPsDataAllocator Allocator)
 {
-	return JsonDeserializer.ReadValue(OutValue, Allocator);
+	if (ReadObject())
+	{
+		if (OutValue == nullptr)
+		{
+			OutValue = Allocator();
+		}
+
+		PsDataTools::FPsDataFriend::Deserialize(OutValue, this);
+
+		PopObject();
+
+		return true;
+	}
+	return false;
 }
 
 void FPsDataStructDeserializer::PopKey(const FString& Key)
 {
-	return JsonDeserializer.PopKey(Key);
+	check(Stack.Num() > 0);
+	auto& Frame = Stack.Last();
+	if (Frame.Type == EFrameType::Object)
+	{
+		check(Frame.Current);
+		Frame.Current = Frame.Current->PropertyLinkNext;
+	}
+	else
+	{
+		check(Frame.Type == EFrameType::Map);
+		++Frame.Index;
+	}
 }
 
 void FPsDataStructDeserializer::PopIndex()
 {
-	return JsonDeserializer.PopIndex();
+	check(Stack.Num() > 0 && Stack.Last().Type == EFrameType::Array);
+	++Stack.Last().Index;
 }
 
 void FPsDataStructDeserializer::PopArray()
 {
-	return JsonDeserializer.PopArray();
+	check(Stack.Num() > 0 && Stack.Last().Type == EFrameType::Array);
+	Stack.Pop(false);
 }
 
 void FPsDataStructDeserializer::PopObject()
 {
-	return JsonDeserializer.PopObject();
+	check(Stack.Num() > 0 && (Stack.Last().Type == EFrameType::Object || Stack.Last().Type == EFrameType::Map));
+	Stack.Pop(false);
 }
 
 /***********************************
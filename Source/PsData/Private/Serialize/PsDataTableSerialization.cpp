@@ -6,57 +6,226 @@
 #include "PsDataCore.h"
 #include "Serialize/PsDataStructSerialization.h"
 
+#include "Async/ParallelFor.h"
 #include "JsonObjectConverter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+constexpr int32 TableImportBatchSize = 256;
+
+struct FTableImportRow
+{
+	FName RowName;
+	uint8* RowData = nullptr;
+	uint32 Hash = 0;
+	bool bReused = false;
+	bool bFailed = false;
+	TArray<FString> Problems;
+};
+
+void DestroyTableRow(const UScriptStruct* Struct, const FTableImportRow& Row)
+{
+	if (Row.RowData && !Row.bReused)
+	{
+		Struct->DestroyStruct(Row.RowData);
+		FMemory::Free(Row.RowData);
+	}
+}
+
+uint32 GetTableRowHash(const TSharedRef<FJsonObject>& JsonObject)
+{
+	FString JsonString;
+	const auto JsonWriter = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&JsonString);
+	FJsonSerializer::Serialize(JsonObject, JsonWriter);
+	return FCrc::StrCrc32(*JsonString);
+}
+} // namespace PsDataTools
 
 /***********************************
  * FPsDataTableSerializer
  ***********************************/
 
-void FPsDataTableSerializer::CreateTableFromJson_Import(UDataTable* DataTable, const TArray<TSharedPtr<FJsonValue>>& JsonArray, TArray<FString>& ImportProblems)
+bool FPsDataTableSerializer::CreateTableFromJson_Import(UDataTable* DataTable, const TArray<TSharedPtr<FJsonValue>>& JsonArray, TArray<FString>& ImportProblems, FPsDataTableImportProgress Progress, TMap<FName, uint32>* RowHashes)
 {
 	const FString KeyField = DataTable->ImportKeyField.IsEmpty() ? TEXT("Name") : DataTable->ImportKeyField;
 
 	auto Struct = DataTable->RowStruct;
 	check(Struct);
 
-	DataTable->EmptyTable();
+	const bool bAllowDuplicateRows = DataTable->AllowDuplicateRowsOnImport();
+	const bool bReportExtraFields = !DataTable->bIgnoreExtraFields;
+
+	// Json converter may touch objects for texts, soft pointers and object properties, so such rows are converted on the game thread
+	const EParallelForFlags ParallelForFlags = FPsDataStructSerializer::IsPlainStruct(Struct) ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+
 	const TMap<FName, uint8*>* ConstRowMap = &DataTable->GetRowMap();
 	const auto RowMap = const_cast<TMap<FName, uint8*>*>(ConstRowMap);
 
-	TMap<FString, FString> KeyMap;
-	for (int32 Index = 0; Index < JsonArray.Num(); ++Index)
+	TArray<PsDataTools::FTableImportRow> NewRows;
+	TMap<FName, int32> NewRowIndices;
+	NewRows.Reserve(JsonArray.Num());
+	NewRowIndices.Reserve(JsonArray.Num());
+
+	bool bFailed = false;
+	TArray<PsDataTools::FTableImportRow> Batch;
+	for (int32 BatchStart = 0; BatchStart < JsonArray.Num(); BatchStart += PsDataTools::TableImportBatchSize)
 	{
-		const TSharedPtr<FJsonValue>& JsonValue = JsonArray[Index];
-		TSharedPtr<FJsonObject> JsonObject = JsonValue->AsObject();
-		if (!JsonObject.IsValid())
+		const int32 BatchNum = FMath::Min(PsDataTools::TableImportBatchSize, JsonArray.Num() - BatchStart);
+		Batch.Reset();
+		Batch.SetNum(BatchNum);
+
+		// Rows are independent, each one is converted into its own slot
+		ParallelFor(BatchNum, [&](int32 BatchIndex) {
+			const int32 Index = BatchStart + BatchIndex;
+			auto& Row = Batch[BatchIndex];
+
+			const TSharedPtr<FJsonValue>& JsonValue = JsonArray[Index];
+			TSharedPtr<FJsonObject> JsonObject = JsonValue->AsObject();
+			if (!JsonObject.IsValid())
+			{
+				Row.Problems.Add(FString::Printf(TEXT("Row '%d' is not a valid JSON object."), Index));
+				Row.bFailed = true;
+				return;
+			}
+
+			Row.RowName = DataTableUtils::MakeValidName(JsonObject->GetStringField(KeyField));
+			if (Row.RowName.IsNone())
+			{
+				Row.Problems.Add(FString::Printf(TEXT("Row '%d' missing key field '%s'."), Index, *KeyField));
+				Row.bFailed = true;
+				return;
+			}
+
+			JsonObject->RemoveField(KeyField);
+
+			if (bReportExtraFields)
+			{
+				ReportAboutExtraFields(Struct, Row.RowName, JsonObject, Row.Problems);
+			}
+
+			if (RowHashes)
+			{
+				Row.Hash = PsDataTools::GetTableRowHash(JsonObject.ToSharedRef());
+
+				// Row memory of an unchanged row is kept as is
+				const uint32* OldHash = RowHashes->Find(Row.RowName);
+				uint8* const* OldRowData = RowMap->Find(Row.RowName);
+				if (OldHash && OldRowData && *OldHash == Row.Hash)
+				{
+					Row.RowData = *OldRowData;
+					Row.bReused = true;
+					return;
+				}
+			}
+
+			const int32 NumProblems = Row.Problems.Num();
+			Row.RowData = FPsDataStructSerializer::CreateStructFromJson_Import(Struct, JsonObject.ToSharedRef(), Row.Problems);
+			Row.bFailed = Row.Problems.Num() > NumProblems;
+		}, ParallelForFlags);
+
+		// Merge in the order of the json array, so problems and rows don't depend on the scheduling
+		for (auto& Row : Batch)
 		{
-			ImportProblems.Add(FString::Printf(TEXT("Row '%d' is not a valid JSON object."), Index));
-			continue;
+			bFailed |= Row.bFailed;
+			if (Row.RowName.IsNone())
+			{
+				ImportProblems.Append(Row.Problems);
+				continue;
+			}
+
+			if (const int32* ExistingIndex = NewRowIndices.Find(Row.RowName))
+			{
+				if (!bAllowDuplicateRows)
+				{
+					ImportProblems.Add(FString::Printf(TEXT("Duplicate row name '%s'."), *Row.RowName.ToString()));
+					PsDataTools::DestroyTableRow(Struct, Row);
+					continue;
+				}
+
+				ImportProblems.Append(Row.Problems);
+				auto& ExistingRow = NewRows[*ExistingIndex];
+				if (ExistingRow.RowData != Row.RowData)
+				{
+					PsDataTools::DestroyTableRow(Struct, ExistingRow);
+				}
+				ExistingRow = MoveTemp(Row);
+				continue;
+			}
+
+			ImportProblems.Append(Row.Problems);
+			NewRowIndices.Add(Row.RowName, NewRows.Num());
+			NewRows.Add(MoveTemp(Row));
 		}
 
-		FName RowName = DataTableUtils::MakeValidName(JsonObject->GetStringField(KeyField));
-		if (RowName.IsNone())
+		if (Progress && !Progress(BatchStart + BatchNum, JsonArray.Num()))
 		{
-			ImportProblems.Add(FString::Printf(TEXT("Row '%d' missing key field '%s'."), Index, *KeyField));
-			continue;
+			for (auto& Row : NewRows)
+			{
+				PsDataTools::DestroyTableRow(Struct, Row);
+			}
+
+			ImportProblems.Add(TEXT("Import was cancelled."));
+			return false;
 		}
+	}
 
-		JsonObject->RemoveField(KeyField);
+	int32 NumReused = 0;
+	TSet<uint8*> ReusedRows;
+	for (const auto& Row : NewRows)
+	{
+		if (Row.bReused)
+		{
+			ReusedRows.Add(Row.RowData);
+			++NumReused;
+		}
+	}
 
-		if (!DataTable->AllowDuplicateRowsOnImport() && RowMap->Contains(RowName))
+	if (ReusedRows.Num() > 0)
+	{
+		for (auto& Pair : *RowMap)
 		{
-			ImportProblems.Add(FString::Printf(TEXT("Duplicate row name '%s'."), *RowName.ToString()));
-			continue;
+			if (!ReusedRows.Contains(Pair.Value))
+			{
+				Struct->DestroyStruct(Pair.Value);
+				FMemory::Free(Pair.Value);
+			}
 		}
+		RowMap->Reset();
+	}
+	else
+	{
+		DataTable->EmptyTable();
+	}
 
-		if (!DataTable->bIgnoreExtraFields)
+	RowMap->Reserve(NewRows.Num());
+	for (const auto& Row : NewRows)
+	{
+		RowMap->Add(Row.RowName, Row.RowData);
+	}
+
+	if (RowHashes)
+	{
+		RowHashes->Reset();
+		for (const auto& Row : NewRows)
 		{
-			ReportAboutExtraFields(Struct, RowName, JsonObject, ImportProblems);
+			// Failed rows are converted again on the next import
+			if (!Row.bFailed)
+			{
+				RowHashes->Add(Row.RowName, Row.Hash);
+			}
 		}
 
-		auto RowStruct = FPsDataStructSerializer::CreateStructFromJson_Import(Struct, JsonObject.ToSharedRef(), ImportProblems);
-		RowMap->Add(RowName, RowStruct);
+		UE_LOG(LogData, Log, TEXT("Import \"%s\": %d rows rebuilt, %d rows kept"), *DataTable->GetName(), NewRows.Num() - NumReused, NumReused);
 	}
+
+	return !bFailed;
 }
 
 void FPsDataTableSerializer::ReportAboutExtraFields(const UScriptStruct* Struct, FName RowName, const TSharedPtr<FJsonObject>& JsonObject, TArray<FString>& ImportProblems)
@@ -83,91 +252,206 @@ void FPsDataTableSerializer::ReportAboutExtraFields(const UScriptStruct* Struct,
  * FPsDataTableDeserializer
  ***********************************/
 
-FPsDataTableDeserializer::FPsDataTableDeserializer(UDataTable* DataTable, const FString& PropertyName)
+FPsDataTableDeserializer::FPsDataTableDeserializer(UDataTable* DataTable, const FString& InPropertyName)
 	: FPsDataDeserializer()
-	, JsonDeserializer(CreateJsonFromTable(DataTable, PropertyName))
+	, Struct(nullptr)
+	, PropertyName(InPropertyName)
+	, Depth(0)
+	, RowDepth(0)
+	, RowIndex(0)
+	, bPropertyPopped(false)
 {
 	check(DataTable);
+	Struct = DataTable->GetRowStruct();
+	check(Struct);
+
+	const TMap<FName, uint8*>& RowMap = DataTable->GetRowMap();
+	Rows.Reserve(RowMap.Num());
+	for (auto& Pair : RowMap)
+	{
+		Rows.Add({Pair.Key, Pair.Key.ToString().ToLower(), Pair.Value});
+	}
+}
+
+bool FPsDataTableDeserializer::IsRowValue() const
+{
+	return Depth == 2 && RowDepth == 0 && Rows.IsValidIndex(RowIndex);
 }
 
 bool FPsDataTableDeserializer::ReadKey(FString& OutKey)
 {
-	return JsonDeserializer.ReadKey(OutKey);
+	if (RowDepth > 0)
+	{
+		return Row->ReadKey(OutKey);
+	}
+
+	if (Depth == 1)
+	{
+		if (!bPropertyPopped && Rows.Num() > 0)
+		{
+			OutKey = PropertyName;
+			return true;
+		}
+	}
+	else if (Depth == 2)
+	{
+		if (Rows.IsValidIndex(RowIndex))
+		{
+			OutKey = Rows[RowIndex].Key;
+			return true;
+		}
+	}
+
+	return false;
 }
 
 bool FPsDataTableDeserializer::ReadIndex()
 {
-	return JsonDeserializer.ReadIndex();
+	if (RowDepth > 0)
+	{
+		return Row->ReadIndex();
+	}
+	return false;
 }
 
 bool FPsDataTableDeserializer::ReadArray()
 {
-	return JsonDeserializer.ReadArray();
+	if (RowDepth > 0 && Row->ReadArray())
+	{
+		++RowDepth;
+		return true;
+	}
+	return false;
 }
 
 bool FPsDataTableDeserializer::ReadObject()
 {
-	return JsonDeserializer.ReadObject();
+	if (RowDepth > 0 || IsRowValue())
+	{
+		if (RowDepth == 0)
+		{
+			Row.Emplace(Struct, Rows[RowIndex].Ptr);
+		}
+
+		if (Row->ReadObject())
+		{
+			++RowDepth;
+			return true;
+		}
+		return false;
+	}
+
+	if (Depth == 0 || (Depth == 1 && !bPropertyPopped && Rows.Num() > 0))
+	{
+		++Depth;
+		return true;
+	}
+
+	return false;
 }
 
 bool FPsDataTableDeserializer::ReadValue(int32& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(int64& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(uint8& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(float& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(bool& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(FString& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(FName& OutValue)
 {
-	return JsonDeserializer.ReadValue(OutValue);
+	return RowDepth > 0 && Row->ReadValue(OutValue);
 }
 
 bool FPsDataTableDeserializer::ReadValue(UPsData*& OutValue, FPsDataAllocator Allocator)
 {
-	return JsonDeserializer.ReadValue(OutValue, Allocator);
+	if (RowDepth > 0)
+	{
+		return Row->ReadValue(OutValue, Allocator);
+	}
+
+	if (ReadObject())
+	{
+		if (OutValue == nullptr)
+		{
+			OutValue = Allocator();
+		}
+
+		PsDataTools::FPsDataFriend::Deserialize(OutValue, this);
+
+		PopObject();
+
+		return true;
+	}
+	return false;
 }
 
 void FPsDataTableDeserializer::PopKey(const FString& Key)
 {
-	return JsonDeserializer.PopKey(Key);
+	if (RowDepth > 0)
+	{
+		Row->PopKey(Key);
+	}
+	else if (Depth == 1)
+	{
+		check(!bPropertyPopped && Key == PropertyName);
+		bPropertyPopped = true;
+	}
+	else
+	{
+		check(Depth == 2 && Rows.IsValidIndex(RowIndex));
+		Row.Reset();
+		++RowIndex;
+	}
 }
 
 void FPsDataTableDeserializer::PopIndex()
 {
-	return JsonDeserializer.PopIndex();
+	check(RowDepth > 0);
+	Row->PopIndex();
 }
 
 void FPsDataTableDeserializer::PopArray()
 {
-	return JsonDeserializer.PopArray();
+	check(RowDepth > 0);
+	Row->PopArray();
+	--RowDepth;
 }
 
 void FPsDataTableDeserializer::PopObject()
 {
-	return JsonDeserializer.PopObject();
+	if (RowDepth > 0)
+	{
+		Row->PopObject();
+		--RowDepth;
+	}
+	else
+	{
+		check(Depth > 0);
+		--Depth;
+	}
 }
 
 TSharedPtr<FJsonObject> FPsDataTableDeserializer::CreateJsonFromTable(UDataTable* DataTable, const FString& PropertyName)
@@ -110,6 +110,14 @@ FString FPsDataBufferInputStream::ReadString()
 	return Result;
 }
 
+void FPsDataBufferInputStream::ReadBuffer(uint8* OutBuffer, int32 Count)
+{
+	check(Count >= 0 && Index + Count <= Buffer.Num());
+	PrevIndex = Index;
+	FMemory::Memcpy(OutBuffer, Buffer.GetData() + Index, Count);
+	Index += Count;
+}
+
 bool FPsDataBufferInputStream::HasData()
 {
 	return Index < Buffer.Num();
@@ -134,6 +142,11 @@ int32 FPsDataBufferInputStream::GetPosition() const
 	return Index;
 }
 
+int32 FPsDataBufferInputStream::GetSize() const
+{
+	return Buffer.Num();
+}
+
 void FPsDataBufferInputStream::CheckRange()
 {
 	check(Index < Buffer.Num());
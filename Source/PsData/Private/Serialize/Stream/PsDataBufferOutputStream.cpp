@@ -27,10 +27,8 @@ void FPsDataBufferOutputStream::Reserve(int32 NumBytes)
 
 void FPsDataBufferOutputStream::WriteUint32(uint32 Value)
 {
-	Buffer.Push(static_cast<uint8>(Value >> 24));
-	Buffer.Push(static_cast<uint8>(Value >> 16));
-	Buffer.Push(static_cast<uint8>(Value >> 8));
-	Buffer.Push(static_cast<uint8>(Value));
+	const int32 Index = Buffer.AddUninitialized(sizeof(Value));
+	PsDataTools::StoreBigEndian(Buffer.GetData() + Index, Value);
 }
 
 void FPsDataBufferOutputStream::WriteInt32(int32 Value)
@@ -47,14 +45,8 @@ void FPsDataBufferOutputStream::WriteInt32(int32 Value)
 
 void FPsDataBufferOutputStream::WriteUint64(uint64 Value)
 {
-	Buffer.Push(static_cast<uint8>(Value >> 56));
-	Buffer.Push(static_cast<uint8>(Value >> 48));
-	Buffer.Push(static_cast<uint8>(Value >> 40));
-	Buffer.Push(static_cast<uint8>(Value >> 32));
-	Buffer.Push(static_cast<uint8>(Value >> 24));
-	Buffer.Push(static_cast<uint8>(Value >> 16));
-	Buffer.Push(static_cast<uint8>(Value >> 8));
-	Buffer.Push(static_cast<uint8>(Value));
+	const int32 Index = Buffer.AddUninitialized(sizeof(Value));
+	PsDataTools::StoreBigEndian(Buffer.GetData() + Index, Value);
 }
 
 void FPsDataBufferOutputStream::WriteInt64(int64 Value)
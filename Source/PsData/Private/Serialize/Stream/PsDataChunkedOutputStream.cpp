@@ -0,0 +1,196 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/Stream/PsDataChunkedOutputStream.h"
+
+/***********************************
+ * FPsDataChunkedOutputStream
+ ***********************************/
+
+FPsDataChunkedOutputStream::FPsDataChunkedOutputStream(int32 InChunkSize)
+	: ChunkSize(InChunkSize)
+	, ChunkIndex(INDEX_NONE)
+	, ChunkCursor(nullptr)
+	, ChunkEnd(nullptr)
+	, bSegmentOpen(false)
+	, TotalSize(0)
+{
+	check(ChunkSize >= sizeof(uint64));
+}
+
+void FPsDataChunkedOutputStream::Reset()
+{
+	ChunkIndex = INDEX_NONE;
+	ChunkCursor = nullptr;
+	ChunkEnd = nullptr;
+	bSegmentOpen = false;
+	TotalSize = 0;
+
+	OwnedBuffers.Reset();
+	Segments.Reset();
+}
+
+void FPsDataChunkedOutputStream::WriteBufferReference(const uint8* Value, int32 Count)
+{
+	if (Count > 0)
+	{
+		Segments.Emplace(Value, Count);
+		bSegmentOpen = false;
+		TotalSize += Count;
+	}
+}
+
+const TArray<TArrayView<const uint8>>& FPsDataChunkedOutputStream::GetSegments() const
+{
+	return Segments;
+}
+
+void FPsDataChunkedOutputStream::CopyTo(TArray<uint8>& OutBuffer) const
+{
+	OutBuffer.Reset(TotalSize);
+	for (const auto& Segment : Segments)
+	{
+		OutBuffer.Append(Segment.GetData(), Segment.Num());
+	}
+}
+
+void FPsDataChunkedOutputStream::CopyTo(FPsDataOutputStream& OutputStream) const
+{
+	for (const auto& Segment : Segments)
+	{
+		OutputStream.WriteBuffer(Segment.GetData(), Segment.Num());
+	}
+}
+
+void FPsDataChunkedOutputStream::WriteUint32(uint32 Value)
+{
+	PsDataTools::StoreBigEndian(Allocate(sizeof(Value)), Value);
+}
+
+void FPsDataChunkedOutputStream::WriteInt32(int32 Value)
+{
+	if (Value < 0)
+	{
+		WriteUint32(static_cast<uint32>(Value * -1) | 0x80000000);
+	}
+	else
+	{
+		WriteUint32(static_cast<uint32>(Value));
+	}
+}
+
+void FPsDataChunkedOutputStream::WriteUint64(uint64 Value)
+{
+	PsDataTools::StoreBigEndian(Allocate(sizeof(Value)), Value);
+}
+
+void FPsDataChunkedOutputStream::WriteInt64(int64 Value)
+{
+	if (Value < 0)
+	{
+		WriteUint64(static_cast<uint64>(Value * -1) | 0x8000000000000000);
+	}
+	else
+	{
+		WriteUint64(static_cast<uint64>(Value));
+	}
+}
+
+void FPsDataChunkedOutputStream::WriteUint8(uint8 Value)
+{
+	*Allocate(1) = Value;
+}
+
+void FPsDataChunkedOutputStream::WriteFloat(float Value)
+{
+	WriteUint32(*reinterpret_cast<uint32*>(&Value));
+}
+
+void FPsDataChunkedOutputStream::WriteBool(bool Value)
+{
+	WriteUint8(Value ? 0x01 : 0x00);
+}
+
+void FPsDataChunkedOutputStream::WriteTCHAR(TCHAR Value)
+{
+	const auto Codepoint = static_cast<uint32>(Value);
+	WriteUint32(Codepoint);
+}
+
+void FPsDataChunkedOutputStream::WriteString(const FString& Value)
+{
+	const auto Converter = FTCHARToUTF8(*Value, Value.Len());
+	WriteUint32(Converter.Length());
+	WriteBuffer(reinterpret_cast<const uint8*>(Converter.Get()), Converter.Length());
+}
+
+void FPsDataChunkedOutputStream::WriteBuffer(const TArray<uint8>& Value)
+{
+	WriteBuffer(Value.GetData(), Value.Num());
+}
+
+void FPsDataChunkedOutputStream::WriteBuffer(const uint8* Value, int32 Count)
+{
+	while (Count > 0)
+	{
+		if (ChunkCursor == ChunkEnd)
+		{
+			NextChunk();
+		}
+
+		const int32 Available = FMath::Min(static_cast<int32>(ChunkEnd - ChunkCursor), Count);
+		FMemory::Memcpy(Allocate(Available), Value, Available);
+		Value += Available;
+		Count -= Available;
+	}
+}
+
+void FPsDataChunkedOutputStream::WriteBuffer(TArray<uint8>&& Value)
+{
+	if (Value.Num() > 0)
+	{
+		const auto& Buffer = OwnedBuffers.Add_GetRef(MoveTemp(Value));
+		WriteBufferReference(Buffer.GetData(), Buffer.Num());
+	}
+}
+
+int32 FPsDataChunkedOutputStream::Size() const
+{
+	return TotalSize;
+}
+
+uint8* FPsDataChunkedOutputStream::Allocate(int32 Count)
+{
+	if (ChunkEnd - ChunkCursor < Count)
+	{
+		NextChunk();
+	}
+
+	if (bSegmentOpen)
+	{
+		auto& Segment = Segments.Last();
+		Segment = TArrayView<const uint8>(Segment.GetData(), Segment.Num() + Count);
+	}
+	else
+	{
+		Segments.Emplace(ChunkCursor, Count);
+		bSegmentOpen = true;
+	}
+
+	uint8* Result = ChunkCursor;
+	ChunkCursor += Count;
+	TotalSize += Count;
+	return Result;
+}
+
+void FPsDataChunkedOutputStream::NextChunk()
+{
+	++ChunkIndex;
+	if (ChunkIndex == Chunks.Num())
+	{
+		Chunks.Emplace(new uint8[ChunkSize]);
+	}
+
+	ChunkCursor = Chunks[ChunkIndex].Get();
+	ChunkEnd = ChunkCursor + ChunkSize;
+	bSegmentOpen = false;
+}
@@ -0,0 +1,35 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/Stream/PsDataCompressedInputStream.h"
+
+/***********************************
+ * FPsDataCompressedInputStream
+ ***********************************/
+
+FPsDataCompressedInputStream::FPsDataCompressedInputStream(TArrayView<const uint8> InView)
+	: FPsDataViewInputStream(InView)
+	, bValid(true)
+{
+	Reset(InView);
+}
+
+bool FPsDataCompressedInputStream::IsValid() const
+{
+	return bValid;
+}
+
+bool FPsDataCompressedInputStream::Reset(TArrayView<const uint8> InView)
+{
+	View = InView;
+	Index = 0;
+	PrevIndex = -1;
+	bValid = true;
+
+	if (PsDataTools::Compression::IsFramed(InView))
+	{
+		bValid = PsDataTools::Compression::Decompress(InView, DecompressedBuffer);
+		View = DecompressedBuffer;
+	}
+
+	return bValid;
+}
@@ -0,0 +1,22 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/Stream/PsDataCompressedOutputStream.h"
+
+/***********************************
+ * FPsDataCompressedOutputStream
+ ***********************************/
+
+FPsDataCompressedOutputStream::FPsDataCompressedOutputStream(TSharedRef<FPsDataOutputStream> InOutputStream, PsDataTools::Compression::EFormat InFormat, int32 InThreshold)
+	: OutputStream(InOutputStream)
+	, Format(InFormat)
+	, Threshold(InThreshold)
+{
+}
+
+void FPsDataCompressedOutputStream::Flush()
+{
+	TArray<uint8> Frame;
+	PsDataTools::Compression::Compress(Buffer, Frame, Format, Threshold);
+	OutputStream->WriteBuffer(MoveTemp(Frame));
+	Reset();
+}
@@ -0,0 +1,102 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/Stream/PsDataCompression.h"
+
+#include "PsData.h"
+#include "Serialize/Stream/PsDataOutputStream.h"
+
+#include "Misc/Compression.h"
+
+/***********************************
+ * Compression frame
+ ***********************************/
+
+namespace PsDataTools
+{
+namespace Compression
+{
+static uint32 LoadBigEndian(const uint8* Ptr)
+{
+	return (static_cast<uint32>(Ptr[0]) << 24) | (static_cast<uint32>(Ptr[1]) << 16) | (static_cast<uint32>(Ptr[2]) << 8) | static_cast<uint32>(Ptr[3]);
+}
+
+EFormat GetDefaultFormat()
+{
+	static const EFormat DefaultFormat = FCompression::IsFormatValid(GetFormatName(EFormat::Oodle)) ? EFormat::Oodle : EFormat::Zlib;
+	return DefaultFormat;
+}
+
+FName GetFormatName(EFormat Format)
+{
+	switch (Format)
+	{
+	case EFormat::Zlib:
+		return NAME_Zlib;
+	case EFormat::Gzip:
+		return NAME_Gzip;
+	case EFormat::LZ4:
+		return NAME_LZ4;
+	case EFormat::Oodle:
+		return TEXT("Oodle");
+	default:
+		return NAME_None;
+	}
+}
+
+bool IsFramed(TArrayView<const uint8> Data)
+{
+	return Data.Num() >= HeaderSize && FMemory::Memcmp(Data.GetData(), Magic, sizeof(Magic)) == 0;
+}
+
+void Compress(TArrayView<const uint8> Data, TArray<uint8>& OutBuffer, EFormat Format, int32 Threshold)
+{
+	const FName FormatName = GetFormatName(Format);
+	if (Data.Num() >= Threshold && !FormatName.IsNone())
+	{
+		const int32 StartIndex = OutBuffer.Num();
+		int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, Data.Num());
+		OutBuffer.AddUninitialized(HeaderSize + CompressedSize);
+
+		uint8* Header = OutBuffer.GetData() + StartIndex;
+		if (FCompression::CompressMemory(FormatName, Header + HeaderSize, CompressedSize, Data.GetData(), Data.Num()) && HeaderSize + CompressedSize < Data.Num())
+		{
+			FMemory::Memcpy(Header, Magic, sizeof(Magic));
+			Header[4] = static_cast<uint8>(Format);
+			StoreBigEndian(Header + 5, static_cast<uint32>(Data.Num()));
+			StoreBigEndian(Header + 9, static_cast<uint32>(CompressedSize));
+			OutBuffer.SetNum(StartIndex + HeaderSize + CompressedSize, false);
+			return;
+		}
+
+		OutBuffer.SetNum(StartIndex, false);
+	}
+
+	OutBuffer.Append(Data.GetData(), Data.Num());
+}
+
+bool Decompress(TArrayView<const uint8> Data, TArray<uint8>& OutBuffer)
+{
+	check(IsFramed(Data));
+
+	const uint8* Header = Data.GetData();
+	const FName FormatName = GetFormatName(static_cast<EFormat>(Header[4]));
+	const int32 UncompressedSize = static_cast<int32>(LoadBigEndian(Header + 5));
+	const int32 CompressedSize = static_cast<int32>(LoadBigEndian(Header + 9));
+	if (FormatName.IsNone() || UncompressedSize < 0 || UncompressedSize > MaxUncompressedSize || CompressedSize < 0 || CompressedSize > Data.Num() - HeaderSize)
+	{
+		UE_LOG(LogData, Error, TEXT("Corrupted compression frame"));
+		return false;
+	}
+
+	OutBuffer.SetNumUninitialized(UncompressedSize);
+	if (!FCompression::UncompressMemory(FormatName, OutBuffer.GetData(), UncompressedSize, Header + HeaderSize, CompressedSize))
+	{
+		UE_LOG(LogData, Error, TEXT("Can't decompress %d bytes of %s data"), CompressedSize, *FormatName.ToString());
+		OutBuffer.Reset();
+		return false;
+	}
+
+	return true;
+}
+} // namespace Compression
+} // namespace PsDataTools
@@ -0,0 +1,232 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#include "Serialize/Stream/PsDataViewInputStream.h"
+
+#include "PsData.h"
+
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+
+/***********************************
+ * FPsDataViewInputStream
+ ***********************************/
+
+FPsDataViewInputStream::FPsDataViewInputStream(TArrayView<const uint8> InView)
+	: View(InView)
+	, Index(0)
+	, PrevIndex(-1)
+{
+}
+
+TSharedPtr<FPsDataViewInputStream> FPsDataViewInputStream::CreateFromFile(const FString& Filename)
+{
+	TUniquePtr<IMappedFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (Handle.IsValid() && Handle->GetFileSize() > 0)
+	{
+		TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion(0, Handle->GetFileSize()));
+		if (Region.IsValid())
+		{
+			const auto Stream = MakeShared<FPsDataViewInputStream>(TArrayView<const uint8>(Region->GetMappedPtr(), static_cast<int32>(Region->GetMappedSize())));
+			Stream->MappedFileHandle = MoveTemp(Handle);
+			Stream->MappedFileRegion = MoveTemp(Region);
+			return Stream;
+		}
+	}
+
+	TArray<uint8> FileBuffer;
+	if (FFileHelper::LoadFileToArray(FileBuffer, *Filename))
+	{
+		const auto Stream = MakeShared<FPsDataViewInputStream>(TArrayView<const uint8>());
+		Stream->FileBuffer = MoveTemp(FileBuffer);
+		Stream->View = Stream->FileBuffer;
+		return Stream;
+	}
+
+	UE_LOG(LogData, Warning, TEXT("Can't read file \"%s\""), *Filename);
+	return nullptr;
+}
+
+TArrayView<const uint8> FPsDataViewInputStream::GetView() const
+{
+	return View;
+}
+
+bool FPsDataViewInputStream::CanRead(int32 Count) const
+{
+	return Count >= 0 && Count <= View.Num() - Index;
+}
+
+PsDataTools::FDataStringViewChar FPsDataViewInputStream::ReadStringView()
+{
+	const int32 RealPrevIndex = Index;
+
+	CheckRange(4);
+	const int32 Len = static_cast<int32>(ReadUint32Unchecked());
+	CheckRange(Len);
+	const PsDataTools::FDataStringViewChar Result(reinterpret_cast<const char*>(View.GetData() + Index), Len);
+	Index += Len;
+
+	PrevIndex = RealPrevIndex;
+	return Result;
+}
+
+TArrayView<const uint8> FPsDataViewInputStream::ReadView(int32 Count)
+{
+	CheckRange(Count);
+	PrevIndex = Index;
+	const TArrayView<const uint8> Result(View.GetData() + Index, Count);
+	Index += Count;
+	return Result;
+}
+
+bool FPsDataViewInputStream::TryReadString(FString& OutValue)
+{
+	const int32 RealPrevIndex = Index;
+	if (!CanRead(4))
+	{
+		return false;
+	}
+
+	const int32 Len = static_cast<int32>(ReadUint32Unchecked());
+	if (!CanRead(Len))
+	{
+		Index = RealPrevIndex;
+		return false;
+	}
+
+	OutValue.Reset();
+	if (Len > 0)
+	{
+		const auto Converter = FUTF8ToTCHAR(reinterpret_cast<const char*>(View.GetData() + Index), Len);
+		OutValue = FString(Converter.Length(), Converter.Get());
+	}
+	Index += Len;
+
+	PrevIndex = RealPrevIndex;
+	return true;
+}
+
+uint32 FPsDataViewInputStream::ReadUint32()
+{
+	CheckRange(4);
+	PrevIndex = Index;
+	return ReadUint32Unchecked();
+}
+
+int32 FPsDataViewInputStream::ReadInt32()
+{
+	const uint32 Value = ReadUint32();
+	if ((Value & 0x80000000) == 0)
+	{
+		return static_cast<int32>(Value);
+	}
+	else
+	{
+		return static_cast<int32>(Value ^ 0x80000000) * -1;
+	}
+}
+
+uint64 FPsDataViewInputStream::ReadUint64()
+{
+	CheckRange(8);
+	PrevIndex = Index;
+	return ReadUint64Unchecked();
+}
+
+int64 FPsDataViewInputStream::ReadInt64()
+{
+	const uint64 Value = ReadUint64();
+	if ((Value & 0x8000000000000000) == 0)
+	{
+		return static_cast<int64>(Value);
+	}
+	else
+	{
+		return static_cast<int64>(Value ^ 0x8000000000000000) * -1;
+	}
+}
+
+uint8 FPsDataViewInputStream::ReadUint8()
+{
+	CheckRange(1);
+	PrevIndex = Index;
+	return ReadUint8Unchecked();
+}
+
+float FPsDataViewInputStream::ReadFloat()
+{
+	const uint32 Value = ReadUint32();
+	return *reinterpret_cast<const float*>(&Value);
+}
+
+bool FPsDataViewInputStream::ReadBool()
+{
+	const auto b0 = ReadUint8();
+	return b0 == 0x01;
+}
+
+TCHAR FPsDataViewInputStream::ReadTCHAR()
+{
+	const auto Codepoint = ReadUint32();
+	return static_cast<TCHAR>(Codepoint);
+}
+
+FString FPsDataViewInputStream::ReadString()
+{
+	const auto StringView = ReadStringView();
+	if (StringView.Len() > 0)
+	{
+		const auto Converter = FUTF8ToTCHAR(StringView.GetData(), StringView.Len());
+		return FString(Converter.Length(), Converter.Get());
+	}
+	return {};
+}
+
+void FPsDataViewInputStream::ReadBuffer(uint8* OutBuffer, int32 Count)
+{
+	CheckRange(Count);
+	PrevIndex = Index;
+	FMemory::Memcpy(OutBuffer, View.GetData() + Index, Count);
+	Index += Count;
+}
+
+bool FPsDataViewInputStream::HasData()
+{
+	return Index < View.Num();
+}
+
+void FPsDataViewInputStream::ShiftBack()
+{
+	check(PrevIndex >= 0);
+	Index = PrevIndex;
+	PrevIndex = -1;
+}
+
+void FPsDataViewInputStream::SetPosition(int32 Value)
+{
+	Index = Value;
+	PrevIndex = -1;
+	check(Index < View.Num());
+}
+
+int32 FPsDataViewInputStream::GetPosition() const
+{
+	return Index;
+}
+
+int32 FPsDataViewInputStream::GetSize() const
+{
+	return View.Num();
+}
+
+TSharedPtr<FPsDataInputStream> FPsDataViewInputStream::Fork() const
+{
+	auto Stream = MakeShared<FPsDataViewInputStream>(View);
+	Stream->SetPosition(Index);
+	return Stream;
+}
+
+void FPsDataViewInputStream::CheckRange(int32 Count) const
+{
+	check(CanRead(Count));
+}
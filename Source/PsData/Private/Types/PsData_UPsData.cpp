@@ -6,6 +6,31 @@
 #include "PsDataLink.h"
 #include "Serialize/PsDataSerialization.h"
 
+#include "Async/ParallelFor.h"
+
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+/** Minimal number of new elements to fill them in parallel */
+constexpr int32 MinParallelElements = 64;
+
+/** Elements of the class don't allocate data while being deserialized */
+bool IsFlatDataClass(UClass* Class)
+{
+	for (const auto Field : FDataReflection::GetFieldsByClass(Class)->GetFieldsList())
+	{
+		if (Field->Context->IsData())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+} // namespace PsDataTools
+
 DEFINE_FUNCTION(UPsDataUPsDataLibrary::execSetMapProperty)
 {
 	P_GET_OBJECT(UPsData, Target);
@@ -204,6 +229,61 @@ void* UPsDataUPsDataLibrary::TypeDeserialize(UPsData* Instance, const FDataField
 	return nullptr;
 }
 
+void UPsDataUPsDataLibrary::TypeDeserializeElements(UPsData* Instance, const FDataField* Field, FPsDataDeserializer* Deserializer, TArray<FString>* OutKeys, TArray<UPsData*>& OutValues, TFunctionRef<UPsData*(int32, const FString&)> GetValue)
+{
+	UClass* Class = CastChecked<UClass>(Field->Context->GetUEType());
+
+	TArray<TUniquePtr<FPsDataDeserializer>> Elements;
+	if (!Deserializer->bParallelCollections || Field->Meta.bCustomType || !PsDataTools::IsFlatDataClass(Class) || !Deserializer->SplitElements(OutKeys, Elements))
+	{
+		FString Key;
+		while (OutKeys ? Deserializer->ReadKey(Key) : Deserializer->ReadIndex())
+		{
+			OutValues.Add(static_cast<UPsData*>(TypeDeserialize(Instance, Field, Deserializer, GetValue(OutValues.Num(), Key))));
+			if (OutKeys)
+			{
+				OutKeys->Add(Key);
+				Deserializer->PopKey(Key);
+			}
+			else
+			{
+				Deserializer->PopIndex();
+			}
+		}
+		return;
+	}
+
+	for (const auto& Element : Elements)
+	{
+		Element->bPatch = Deserializer->bPatch;
+	}
+
+	// Objects are created on the game thread, existing elements can have subscribers so they are filled here as well
+	TArray<int32> NewIndices;
+	OutValues.SetNumZeroed(Elements.Num());
+	for (int32 i = 0; i < Elements.Num(); ++i)
+	{
+		UPsData* CurrentValue = GetValue(i, OutKeys ? (*OutKeys)[i] : FString());
+		if (CurrentValue)
+		{
+			OutValues[i] = static_cast<UPsData*>(TypeDeserialize(Instance, Field, Elements[i].Get(), CurrentValue));
+		}
+		else
+		{
+			OutValues[i] = FPsDataAllocator(Class, Instance)();
+			NewIndices.Add(i);
+		}
+	}
+
+	// New elements aren't attached until the property is set, so nothing observes them while they are filled
+	ParallelFor(
+		NewIndices.Num(), [&](int32 Index) {
+			const int32 i = NewIndices[Index];
+			OutValues[i] = static_cast<UPsData*>(TypeDeserialize(Instance, Field, Elements[i].Get(), OutValues[i]));
+		},
+		NewIndices.Num() < PsDataTools::MinParallelElements);
+}
+
 bool UPsDataUPsDataLibrary::IsA(const FAbstractDataTypeContext* LeftContext, const FAbstractDataTypeContext* RightContext)
 {
 	UClass* RClass = Cast<UClass>(RightContext->GetUEType());
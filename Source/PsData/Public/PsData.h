@@ -27,11 +27,18 @@ class UPsNetworkData;
 
 struct FAbstractDataProperty;
 struct FAbstractDataLinkProperty;
+struct FPsDataJournal;
+
+struct FPsDataBinaryDeserializer;
 
 namespace PsDataTools
 {
 struct FClassFields;
-}
+struct FDataContainerDelta;
+} // namespace PsDataTools
+
+/** Writer of the element operations of a container change */
+using FPsDataDeltaWriter = TFunctionRef<void(PsDataTools::FDataContainerDelta& Delta)>;
 
 class PSDATA_API FDataDelegates
 {
@@ -177,8 +184,12 @@ struct PSDATA_API FPsDataFriend
 {
 	static void ChangeDataName(UPsData* Data, const FString& Name, const FString& CollectionName);
 	static void AddChild(UPsData* Parent, UPsData* Data);
+	static void AttachChild(UPsData* Parent, UPsData* Data);
+	static bool HasChangeTracking(const UPsData* Data);
 	static void RemoveChild(UPsData* Parent, UPsData* Data);
 	static void Changed(UPsData* Data, const FDataField* Field);
+	static void ChangedElements(UPsData* Data, const FDataField* Field, FPsDataDeltaWriter DeltaWriter);
+	static void SetJournal(UPsData* Data, FPsDataJournal* Journal);
 	static void InitProperties(UPsData* Data);
 	static bool ShouldBeGenerateStruct(UPsData* Data);
 	static void InitStructProperties(UPsData* Data);
@@ -190,6 +201,7 @@ struct PSDATA_API FPsDataFriend
 	static const FAbstractDataLinkProperty* GetLink(const UPsData* Data, int32 Index);
 	static void Serialize(const UPsData* Data, FPsDataSerializer* Serializer);
 	static void Deserialize(UPsData* Data, FPsDataDeserializer* Deserializer);
+	static void PostDeserialize(UPsData* Data);
 	static const FPsDataImprint& GetImprint(const UPsData* Data);
 	static const TSet<UPsData*>& GetChildren(const UPsData* Data);
 	static FPsDataBind BindInternal(const UPsData* Data, const FString& Type, const FPsDataDynamicDelegate& Delegate, EDataBindFlags Flags, const FDataField* Field = nullptr);
@@ -212,6 +224,7 @@ struct PSDATA_API FAbstractDataProperty
 	virtual void Reset() = 0;
 	virtual bool IsDefault() const = 0;
 	virtual void Allocate() {}
+	virtual bool ApplyDelta(FPsDataBinaryDeserializer* Deserializer) { return false; }
 	virtual const FDataField* GetField() const = 0;
 	virtual UPsData* GetOwner() = 0;
 	virtual UPsData* GetOwner() const = 0;
@@ -272,6 +285,9 @@ private:
 	UPROPERTY()
 	UPsNetworkData* Network;
 
+	/** Journal */
+	FPsDataJournal* Journal;
+
 	/** Children */
 	UPROPERTY()
 	TSet<UPsData*> Children;
@@ -291,9 +307,6 @@ private:
 	/** Data imprint */
 	mutable FPsDataImprint Imprint;
 
-	/** Async serialize buffer size after concatenation */
-	mutable int32 SerializeBufferSize;
-
 	/** Class fields */
 	const PsDataTools::FClassFields* ClassFields;
 
@@ -303,21 +316,27 @@ private:
 	/** Add child */
 	void AddChild(UPsData* Child);
 
+	/** Add child without events and commits, the value of the parent doesn't change (materialized lazy data) */
+	void AttachChild(UPsData* Child);
+
 	/** Remove child */
 	void RemoveChild(UPsData* Child);
 
 	/** Change name */
 	void ChangeName(const FString& Name, const FString& CollectionName);
 
-	/** Changed */
-	void Changed(const FDataField* Field);
+	/** Changed, the delta writer describes the change of a container element by element */
+	void Changed(const FDataField* Field, const FPsDataDeltaWriter* DeltaWriter = nullptr);
 
 	/** Add to root data */
-	void AddToRootData();
+	void AddToRootData(bool bBroadcast = true);
 
 	/** Remove from root data */
 	void RemoveFromRootData();
 
+	/** Set journal of the subtree */
+	void SetJournal(FPsDataJournal* InJournal);
+
 	/** Drop imprint */
 	void DropImprint() const;
 
@@ -420,8 +439,8 @@ public:
 	/** Async Serialize */
 	void DataSerializeAsync(FPsDataSerializer* Serializer, FPsDataAsyncSerializeDelegate CallbackDelegate) const;
 
-	/** Deserialize */
-	void DataDeserialize(FPsDataDeserializer* Deserializer, bool bPatch = false);
+	/** Deserialize, bParallelCollections fills collections of flat data on worker threads (see FPsDataDeserializer::bParallelCollections) */
+	void DataDeserialize(FPsDataDeserializer* Deserializer, bool bPatch = false, bool bParallelCollections = false);
 
 private:
 	/** Serialize */
@@ -13,6 +13,8 @@
 #define OLD_CSV_IMPORT_FACTORY ENGINE_MINOR_VERSION < 25
 #define OLD_PROPERTY_STYLE ENGINE_MINOR_VERSION < 25
 
+#define PSDATA_DEPRECATED(Message) [[deprecated(Message " This API will be removed in a future version of PsData.")]] // Plugin API deprecation, independent of the engine version
+
 #if OLD_PROPERTY_STYLE
 using FProperty = UProperty;
 using FNumericProperty = UNumericProperty;
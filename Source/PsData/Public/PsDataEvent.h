@@ -18,6 +18,8 @@ public:
 private:
 	void Invoke();
 
+	bool bActive;
+
 public:
 	static void AddCallback(FPsDataEventScopeGuardCallback Function);
 	static bool IsGuarded();
@@ -26,6 +26,8 @@ struct PSDATA_API FDataMetaType
 	static const FDataStringViewChar Nullable;
 	static const FDataStringViewChar Hidden;
 	static const FDataStringViewChar CustomType;
+	static const FDataStringViewChar Lazy;
+	static const FDataStringViewChar NetPriority;
 };
 
 /***********************************
@@ -80,6 +82,8 @@ struct PSDATA_API FDataFieldMeta
 	bool bDefault;
 	bool bHidden;
 	bool bCustomType;
+	bool bLazy;
+	int32 NetPriority;
 	FString Alias;
 	FString EventType;
 
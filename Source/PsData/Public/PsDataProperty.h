@@ -7,7 +7,10 @@
 #include "PsDataField.h"
 #include "PsDataTraits.h"
 #include "PsDataUtils.h"
+#include "Serialize/PsDataBinarySerialization.h"
 #include "Serialize/PsDataSerialization.h"
+#include "Serialize/Stream/PsDataBufferOutputStream.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
 
 #include "CoreMinimal.h"
 
@@ -257,6 +260,30 @@ struct TTypeDeserializer<TArray<T>>
 	}
 };
 
+template <typename T>
+struct TTypeBulkArraySerializer
+{
+	static void Serialize(const UPsData* Instance, const FDataField* Field, FPsDataSerializer* Serializer, const TArray<T>& Value)
+	{
+		Serializer->WriteValues(Value);
+	}
+};
+
+template <typename T>
+struct TTypeBulkArrayDeserializer
+{
+	static TArray<T> Deserialize(UPsData* Instance, const FDataField* Field, FPsDataDeserializer* Deserializer, const TArray<T>& Value)
+	{
+		TArray<T> NewValue;
+		if (!Deserializer->ReadValues(NewValue))
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s::%s\" as \"%s\""), *Instance->GetClass()->GetName(), *Field->Name, *FType<TArray<T>>::Type())
+		}
+
+		return NewValue;
+	}
+};
+
 template <typename T>
 struct TTypeSerializer<TMap<FString, T>>
 {
@@ -304,6 +331,254 @@ struct TTypeDeserializer<TMap<FString, T>>
 	}
 };
 
+/***********************************
+ * Lazy value
+ ***********************************/
+
+/** Value of a lazy data property kept in the binary format until the first access */
+struct FDataLazyValue
+{
+	TSharedPtr<const TArray<uint8>> Bytes;
+
+	bool IsSet() const
+	{
+		return Bytes.IsValid();
+	}
+
+	/** Keep the value instead of deserializing it, returns false if the field isn't lazy or the deserializer can't keep it */
+	bool Read(UPsData* Owner, const FDataField* Field, FPsDataDeserializer* Deserializer)
+	{
+		// Network and journal commit the added children only, so a tracked value is deserialized at once
+		if (!Field->Meta.bLazy || Deserializer->bPatch || FPsDataFriend::HasChangeTracking(Owner))
+		{
+			return false;
+		}
+
+		auto NewBytes = Deserializer->ReadBinaryValue();
+		if (!NewBytes.IsValid())
+		{
+			return false;
+		}
+
+		Bytes = MoveTemp(NewBytes);
+		return true;
+	}
+
+	void Write(FPsDataSerializer* Serializer) const
+	{
+		if (!Serializer->WriteBinaryValue(*Bytes))
+		{
+			FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataViewInputStream>(*Bytes));
+			if (!Deserializer.CopyValue(Serializer))
+			{
+				UE_LOG(LogData, Error, TEXT("Lazy value of %d bytes is corrupted and can't be copied"), Bytes->Num());
+			}
+		}
+	}
+
+	/** Deserialize and release the kept value */
+	template <typename T>
+	T Deserialize(UPsData* Owner, const FDataField* Field)
+	{
+		const TSharedPtr<const TArray<uint8>> KeptBytes = MoveTemp(Bytes);
+		FPsDataBinaryDeserializer Deserializer(MakeShared<FPsDataViewInputStream>(*KeptBytes));
+		return TTypeDeserializer<T>::Deserialize(Owner, Field, &Deserializer, TTypeDefault<T>::GetDefaultValue());
+	}
+
+	/** Release the kept value, returns true if it was set */
+	bool Reset()
+	{
+		const bool bWasSet = Bytes.IsValid();
+		Bytes.Reset();
+		return bWasSet;
+	}
+};
+
+/***********************************
+ * Container delta
+ ***********************************/
+
+/**
+ * Element operations of scalar container changes: set, insert or remove by index for arrays, set or remove by key for maps.
+ * Operations are written in the binary format and applied in the same order by ApplyArray/ApplyMap.
+ */
+struct FDataContainerDelta
+{
+	enum class EOperation : uint8
+	{
+		Set = 0,
+		Insert = 1,
+		Remove = 2
+	};
+
+	TArray<uint8> Bytes;
+	int32 NumOperations = 0;
+	int32 NumElements = 0;
+
+	void Reset()
+	{
+		Bytes.Reset();
+		NumOperations = 0;
+		NumElements = 0;
+	}
+
+	/** Delta is worth sending if it has fewer operations than the container has elements */
+	bool IsCompact() const
+	{
+		return NumOperations <= NumElements;
+	}
+
+	template <typename T>
+	void WriteArray(const UPsData* Owner, const FDataField* Field, const TArray<T>& OldValue, const TArray<T>& NewValue)
+	{
+		const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+		OutputStream->GetBuffer() = MoveTemp(Bytes);
+		FPsDataBinarySerializer Serializer(OutputStream);
+
+		// Only the middle part between the common prefix and suffix is changed
+		const int32 MinNum = FMath::Min(OldValue.Num(), NewValue.Num());
+		int32 Prefix = 0;
+		while (Prefix < MinNum && TTypeComparator<T>::Compare(OldValue[Prefix], NewValue[Prefix]))
+		{
+			++Prefix;
+		}
+
+		int32 Suffix = 0;
+		while (Suffix < MinNum - Prefix && TTypeComparator<T>::Compare(OldValue[OldValue.Num() - Suffix - 1], NewValue[NewValue.Num() - Suffix - 1]))
+		{
+			++Suffix;
+		}
+
+		const int32 NumOld = OldValue.Num() - Prefix - Suffix;
+		const int32 NumNew = NewValue.Num() - Prefix - Suffix;
+		const int32 NumSet = FMath::Min(NumOld, NumNew);
+
+		for (int32 i = 0; i < NumNew; ++i)
+		{
+			const int32 Index = Prefix + i;
+			WriteOperation(*OutputStream, i < NumSet ? EOperation::Set : EOperation::Insert);
+			OutputStream->WriteUint32(Index);
+			TTypeSerializer<T>::Serialize(Owner, Field, &Serializer, NewValue[Index]);
+		}
+
+		if (NumOld > NumSet)
+		{
+			WriteOperation(*OutputStream, EOperation::Remove);
+			OutputStream->WriteUint32(Prefix + NumSet);
+			OutputStream->WriteUint32(NumOld - NumSet);
+		}
+
+		Bytes = MoveTemp(OutputStream->GetBuffer());
+		NumElements = NewValue.Num();
+	}
+
+	template <typename T>
+	void WriteMap(const UPsData* Owner, const FDataField* Field, const TMap<FString, T>& OldValue, const TMap<FString, T>& NewValue)
+	{
+		const auto OutputStream = MakeShared<FPsDataBufferOutputStream>();
+		OutputStream->GetBuffer() = MoveTemp(Bytes);
+		FPsDataBinarySerializer Serializer(OutputStream);
+
+		for (const auto& Pair : NewValue)
+		{
+			const T* OldElement = OldValue.Find(Pair.Key);
+			if (!OldElement || !TTypeComparator<T>::Compare(*OldElement, Pair.Value))
+			{
+				WriteOperation(*OutputStream, EOperation::Set);
+				OutputStream->WriteString(Pair.Key);
+				TTypeSerializer<T>::Serialize(Owner, Field, &Serializer, Pair.Value);
+			}
+		}
+
+		for (const auto& Pair : OldValue)
+		{
+			if (!NewValue.Contains(Pair.Key))
+			{
+				WriteOperation(*OutputStream, EOperation::Remove);
+				OutputStream->WriteString(Pair.Key);
+			}
+		}
+
+		Bytes = MoveTemp(OutputStream->GetBuffer());
+		NumElements = NewValue.Num();
+	}
+
+	/** Apply the operations written by WriteArray, returns false if they don't match the array */
+	template <typename T>
+	static bool ApplyArray(UPsData* Owner, const FDataField* Field, FPsDataBinaryDeserializer* Deserializer, TArray<T>& Value)
+	{
+		const auto InputStream = Deserializer->GetInputStream();
+		const int32 Num = InputStream->ReadUint32();
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const auto Operation = static_cast<EOperation>(InputStream->ReadUint8());
+			const int32 Index = InputStream->ReadUint32();
+			if (Index < 0)
+			{
+				return false;
+			}
+
+			if (Operation == EOperation::Set && Value.IsValidIndex(Index))
+			{
+				Value[Index] = TTypeDeserializer<T>::Deserialize(Owner, Field, Deserializer, Value[Index]);
+			}
+			else if (Operation == EOperation::Insert && Index <= Value.Num())
+			{
+				Value.Insert(TTypeDeserializer<T>::Deserialize(Owner, Field, Deserializer, TTypeDefault<T>::GetDefaultValue()), Index);
+			}
+			else if (Operation == EOperation::Remove)
+			{
+				const int32 Count = InputStream->ReadUint32();
+				if (Count < 0 || Count > Value.Num() - Index)
+				{
+					return false;
+				}
+				Value.RemoveAt(Index, Count);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Apply the operations written by WriteMap, returns false if they don't match the map */
+	template <typename T>
+	static bool ApplyMap(UPsData* Owner, const FDataField* Field, FPsDataBinaryDeserializer* Deserializer, TMap<FString, T>& Value)
+	{
+		const auto InputStream = Deserializer->GetInputStream();
+		const int32 Num = InputStream->ReadUint32();
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const auto Operation = static_cast<EOperation>(InputStream->ReadUint8());
+			const FString Key = InputStream->ReadString();
+			if (Operation == EOperation::Set)
+			{
+				T* Find = Value.Find(Key);
+				T NewElement = TTypeDeserializer<T>::Deserialize(Owner, Field, Deserializer, Find ? *Find : TTypeDefault<T>::GetDefaultValue());
+				Value.Add(Key, MoveTemp(NewElement));
+			}
+			else if (Operation == EOperation::Remove)
+			{
+				Value.Remove(Key);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	void WriteOperation(FPsDataOutputStream& OutputStream, EOperation Operation)
+	{
+		OutputStream.WriteUint8(static_cast<uint8>(Operation));
+		++NumOperations;
+	}
+};
+
 /***********************************
  * Property
  ***********************************/
@@ -419,9 +694,25 @@ struct TDataProperty<TArray<T>> : public FAbstractDataProperty
 			return;
 		}
 
+		const TArray<T> OldValue = MoveTemp(Value);
 		Value = NewValue;
 
+		FPsDataFriend::ChangedElements(GetOwner(), GetField(), [this, &OldValue](FDataContainerDelta& Delta) {
+			Delta.WriteArray(GetOwner(), GetField(), OldValue, Value);
+		});
+	}
+
+	virtual bool ApplyDelta(FPsDataBinaryDeserializer* Deserializer) override
+	{
+		FPsDataEventScopeGuard EventGuard;
+
+		if (!FDataContainerDelta::ApplyArray(GetOwner(), GetField(), Deserializer, Value))
+		{
+			return false;
+		}
+
 		FPsDataFriend::Changed(GetOwner(), GetField());
+		return true;
 	}
 };
 
@@ -449,7 +740,65 @@ struct TDataProperty<TMap<FString, T>> : public FAbstractDataProperty
 
 	virtual void Deserialize(FPsDataDeserializer* Deserializer) override
 	{
-		SetValue(TTypeDeserializer<TMap<FString, T>>::Deserialize(GetOwner(), GetField(), Deserializer, Value));
+		if (Deserializer->bPatch)
+		{
+			Patch(Deserializer);
+		}
+		else
+		{
+			SetValue(TTypeDeserializer<TMap<FString, T>>::Deserialize(GetOwner(), GetField(), Deserializer, Value));
+		}
+	}
+
+	/** Change only the elements of the patch in place */
+	void Patch(FPsDataDeserializer* Deserializer)
+	{
+		FPsDataEventScopeGuard EventGuard;
+
+		const auto Field = GetField();
+		if (!Deserializer->ReadObject())
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s::%s\" as \"%s\""), *GetOwner()->GetClass()->GetName(), *Field->Name, *FType<TMap<FString, T>>::Type())
+			return;
+		}
+
+		bool bChange = false;
+		FString Key;
+		while (Deserializer->ReadKey(Key))
+		{
+			if (Deserializer->ReadDeleted())
+			{
+				bChange |= Value.Remove(Key) > 0;
+			}
+			else if (T* Find = Value.Find(Key))
+			{
+				T NewElement = TTypeDeserializer<T>::Deserialize(GetOwner(), Field, Deserializer, *Find);
+				if (!TTypeComparator<T>::Compare(*Find, NewElement))
+				{
+					*Find = MoveTemp(NewElement);
+					bChange = true;
+				}
+			}
+			else
+			{
+#if !UE_BUILD_SHIPPING
+				if (!IsValidKey(Key))
+				{
+					UE_LOG(LogData, Fatal, TEXT("Illegal key \"%s\" for map %s::%s"), *Key, *GetOwner()->GetClass()->GetName(), *Field->Name);
+				}
+#endif
+				Value.Add(Key, TTypeDeserializer<T>::Deserialize(GetOwner(), Field, Deserializer, TTypeDefault<T>::GetDefaultValue()));
+				bSorted = false;
+				bChange = true;
+			}
+			Deserializer->PopKey(Key);
+		}
+		Deserializer->PopObject();
+
+		if (bChange)
+		{
+			FPsDataFriend::Changed(GetOwner(), Field);
+		}
 	}
 
 	virtual void Reset() override
@@ -493,10 +842,27 @@ struct TDataProperty<TMap<FString, T>> : public FAbstractDataProperty
 		}
 #endif
 
+		const TMap<FString, T> OldValue = MoveTemp(Value);
 		Value = NewValue;
 		bSorted = false;
 
+		FPsDataFriend::ChangedElements(GetOwner(), GetField(), [this, &OldValue](FDataContainerDelta& Delta) {
+			Delta.WriteMap(GetOwner(), GetField(), OldValue, Value);
+		});
+	}
+
+	virtual bool ApplyDelta(FPsDataBinaryDeserializer* Deserializer) override
+	{
+		FPsDataEventScopeGuard EventGuard;
+
+		if (!FDataContainerDelta::ApplyMap(GetOwner(), GetField(), Deserializer, Value))
+		{
+			return false;
+		}
+
+		bSorted = false;
 		FPsDataFriend::Changed(GetOwner(), GetField());
+		return true;
 	}
 
 	void Sort() const
@@ -519,6 +885,7 @@ template <typename T>
 struct TDataProperty<T*> : public FAbstractDataProperty
 {
 	T* Value;
+	mutable FDataLazyValue Lazy;
 
 	TDataProperty()
 		: Value(nullptr)
@@ -529,12 +896,25 @@ struct TDataProperty<T*> : public FAbstractDataProperty
 
 	virtual void Serialize(FPsDataSerializer* Serializer) const override
 	{
-		TTypeSerializer<T*>::Serialize(GetOwner(), GetField(), Serializer, GetValue());
+		if (Lazy.IsSet())
+		{
+			Lazy.Write(Serializer);
+		}
+		else
+		{
+			TTypeSerializer<T*>::Serialize(GetOwner(), GetField(), Serializer, GetValue());
+		}
 	}
 
 	virtual void Deserialize(FPsDataDeserializer* Deserializer) override
 	{
-		SetValue(TTypeDeserializer<T*>::Deserialize(GetOwner(), GetField(), Deserializer, Value));
+		if (Value == nullptr && Lazy.Read(GetOwner(), GetField(), Deserializer))
+		{
+			FPsDataFriend::Changed(GetOwner(), GetField());
+			return;
+		}
+
+		SetValue(TTypeDeserializer<T*>::Deserialize(GetOwner(), GetField(), Deserializer, GetValue()));
 	}
 
 	virtual void Reset() override
@@ -557,16 +937,18 @@ struct TDataProperty<T*> : public FAbstractDataProperty
 
 	virtual bool IsDefault() const override
 	{
-		return Value == nullptr;
+		return Value == nullptr && !Lazy.IsSet();
 	}
 
 	const T* GetValue() const
 	{
+		Materialize();
 		return Value;
 	}
 
 	T*& GetValue()
 	{
+		Materialize();
 		return Value;
 	}
 
@@ -580,7 +962,8 @@ struct TDataProperty<T*> : public FAbstractDataProperty
 			check(NewValue != nullptr);
 		}
 
-		if (Value == NewValue)
+		const bool bLazyReleased = Lazy.Reset();
+		if (Value == NewValue && !bLazyReleased)
 		{
 			return;
 		}
@@ -600,6 +983,22 @@ struct TDataProperty<T*> : public FAbstractDataProperty
 
 		FPsDataFriend::Changed(GetOwner(), Field);
 	}
+
+	/** Deserialize the lazy value on the first access, it's attached without events and commits since the value doesn't change */
+	void Materialize() const
+	{
+		if (Lazy.IsSet())
+		{
+			const auto Field = GetField();
+			auto& MutableValue = const_cast<TDataProperty*>(this)->Value;
+			MutableValue = Lazy.Deserialize<T*>(GetOwner(), Field);
+			if (MutableValue)
+			{
+				FPsDataFriend::ChangeDataName(CastToPsData(MutableValue), Field->Name, TEXT(""));
+				FPsDataFriend::AttachChild(GetOwner(), CastToPsData(MutableValue));
+			}
+		}
+	}
 };
 
 /***********************************
@@ -610,6 +1009,7 @@ template <typename T>
 struct TDataProperty<TArray<T*>> : public FAbstractDataProperty
 {
 	TArray<T*> Value;
+	mutable FDataLazyValue Lazy;
 
 	TDataProperty()
 	{
@@ -619,12 +1019,25 @@ struct TDataProperty<TArray<T*>> : public FAbstractDataProperty
 
 	virtual void Serialize(FPsDataSerializer* Serializer) const override
 	{
-		TTypeSerializer<TArray<T*>>::Serialize(GetOwner(), GetField(), Serializer, GetValue());
+		if (Lazy.IsSet())
+		{
+			Lazy.Write(Serializer);
+		}
+		else
+		{
+			TTypeSerializer<TArray<T*>>::Serialize(GetOwner(), GetField(), Serializer, GetValue());
+		}
 	}
 
 	virtual void Deserialize(FPsDataDeserializer* Deserializer) override
 	{
-		SetValue(TTypeDeserializer<TArray<T*>>::Deserialize(GetOwner(), GetField(), Deserializer, Value));
+		if (Value.Num() == 0 && Lazy.Read(GetOwner(), GetField(), Deserializer))
+		{
+			FPsDataFriend::Changed(GetOwner(), GetField());
+			return;
+		}
+
+		SetValue(TTypeDeserializer<TArray<T*>>::Deserialize(GetOwner(), GetField(), Deserializer, GetValue()));
 	}
 
 	virtual void Reset() override
@@ -634,16 +1047,18 @@ struct TDataProperty<TArray<T*>> : public FAbstractDataProperty
 
 	virtual bool IsDefault() const override
 	{
-		return Value.Num() == 0;
+		return Value.Num() == 0 && !Lazy.IsSet();
 	}
 
 	const TArray<T*>& GetValue() const
 	{
+		Materialize();
 		return Value;
 	}
 
 	TArray<T*>& GetValue()
 	{
+		Materialize();
 		return Value;
 	}
 
@@ -651,7 +1066,7 @@ struct TDataProperty<TArray<T*>> : public FAbstractDataProperty
 	{
 		FPsDataEventScopeGuard EventGuard;
 
-		bool bChange = false;
+		bool bChange = Lazy.Reset();
 		const auto Field = GetField();
 
 		for (int32 i = 0; i < NewValue.Num(); ++i)
@@ -684,6 +1099,23 @@ struct TDataProperty<TArray<T*>> : public FAbstractDataProperty
 
 		FPsDataFriend::Changed(GetOwner(), Field);
 	}
+
+	/** Deserialize the lazy value on the first access, it's attached without events and commits since the value doesn't change */
+	void Materialize() const
+	{
+		if (Lazy.IsSet())
+		{
+			const auto Field = GetField();
+			auto& MutableValue = const_cast<TDataProperty*>(this)->Value;
+			MutableValue = Lazy.Deserialize<TArray<T*>>(GetOwner(), Field);
+			for (int32 i = 0; i < MutableValue.Num(); ++i)
+			{
+				auto NewData = CastToPsData(MutableValue[i]);
+				FPsDataFriend::ChangeDataName(NewData, FString::FromInt(i), Field->Name);
+				FPsDataFriend::AttachChild(GetOwner(), NewData);
+			}
+		}
+	}
 };
 
 /***********************************
@@ -695,6 +1127,7 @@ struct TDataProperty<TMap<FString, T*>> : public FAbstractDataProperty
 {
 	mutable TMap<FString, T*> Value;
 	mutable bool bSorted;
+	mutable FDataLazyValue Lazy;
 
 	TDataProperty()
 		: bSorted(true)
@@ -705,12 +1138,92 @@ struct TDataProperty<TMap<FString, T*>> : public FAbstractDataProperty
 
 	virtual void Serialize(FPsDataSerializer* Serializer) const override
 	{
-		TTypeSerializer<TMap<FString, T*>>::Serialize(GetOwner(), GetField(), Serializer, GetValue());
+		if (Lazy.IsSet())
+		{
+			Lazy.Write(Serializer);
+		}
+		else
+		{
+			TTypeSerializer<TMap<FString, T*>>::Serialize(GetOwner(), GetField(), Serializer, GetValue());
+		}
 	}
 
 	virtual void Deserialize(FPsDataDeserializer* Deserializer) override
 	{
-		SetValue(TTypeDeserializer<TMap<FString, T*>>::Deserialize(GetOwner(), GetField(), Deserializer, Value));
+		if (Value.Num() == 0 && Lazy.Read(GetOwner(), GetField(), Deserializer))
+		{
+			FPsDataFriend::Changed(GetOwner(), GetField());
+			return;
+		}
+
+		if (Deserializer->bPatch)
+		{
+			Patch(Deserializer);
+		}
+		else
+		{
+			SetValue(TTypeDeserializer<TMap<FString, T*>>::Deserialize(GetOwner(), GetField(), Deserializer, GetValue()));
+		}
+	}
+
+	/** Change only the elements of the patch in place, existing elements are patched as well */
+	void Patch(FPsDataDeserializer* Deserializer)
+	{
+		FPsDataEventScopeGuard EventGuard;
+
+		Materialize();
+
+		const auto Field = GetField();
+		if (!Deserializer->ReadObject())
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s::%s\" as \"%s\""), *GetOwner()->GetClass()->GetName(), *Field->Name, *FType<TMap<FString, T*>>::Type())
+			return;
+		}
+
+		bool bChange = false;
+		FString Key;
+		while (Deserializer->ReadKey(Key))
+		{
+			T* const* Find = Value.Find(Key);
+			T* CurrentValue = Find ? *Find : nullptr;
+			T* NewValue = Deserializer->ReadDeleted() ? nullptr : TTypeDeserializer<T*>::Deserialize(GetOwner(), Field, Deserializer, CurrentValue);
+			Deserializer->PopKey(Key);
+
+			if (NewValue == CurrentValue)
+			{
+				continue;
+			}
+
+			if (CurrentValue)
+			{
+				FPsDataFriend::RemoveChild(GetOwner(), CastToPsData(CurrentValue));
+				Value.Remove(Key);
+			}
+
+			// Map can't hold null, so null removes the element as well
+			if (NewValue)
+			{
+#if !UE_BUILD_SHIPPING
+				if (!IsValidKey(Key))
+				{
+					UE_LOG(LogData, Fatal, TEXT("Illegal key \"%s\" for map %s::%s"), *Key, *GetOwner()->GetClass()->GetName(), *Field->Name);
+				}
+#endif
+				auto NewData = CastToPsData(NewValue);
+				FPsDataFriend::ChangeDataName(NewData, Key, Field->Name);
+				FPsDataFriend::AddChild(GetOwner(), NewData);
+				Value.Add(Key, NewValue);
+				bSorted = false;
+			}
+
+			bChange = true;
+		}
+		Deserializer->PopObject();
+
+		if (bChange)
+		{
+			FPsDataFriend::Changed(GetOwner(), Field);
+		}
 	}
 
 	virtual void Reset() override
@@ -720,17 +1233,19 @@ struct TDataProperty<TMap<FString, T*>> : public FAbstractDataProperty
 
 	virtual bool IsDefault() const override
 	{
-		return Value.Num() == 0;
+		return Value.Num() == 0 && !Lazy.IsSet();
 	}
 
 	const TMap<FString, T*>& GetValue() const
 	{
+		Materialize();
 		Sort();
 		return Value;
 	}
 
 	TMap<FString, T*>& GetValue()
 	{
+		Materialize();
 		Sort();
 		return Value;
 	}
@@ -749,7 +1264,7 @@ struct TDataProperty<TMap<FString, T*>> : public FAbstractDataProperty
 		}
 #endif
 
-		bool bChange = false;
+		bool bChange = Lazy.Reset();
 		const auto Field = GetField();
 
 		for (auto& Pair : NewValue)
@@ -794,6 +1309,23 @@ struct TDataProperty<TMap<FString, T*>> : public FAbstractDataProperty
 			});
 		}
 	}
+
+	/** Deserialize the lazy value on the first access, it's attached without events and commits since the value doesn't change */
+	void Materialize() const
+	{
+		if (Lazy.IsSet())
+		{
+			const auto Field = GetField();
+			Value = Lazy.Deserialize<TMap<FString, T*>>(GetOwner(), Field);
+			bSorted = false;
+			for (const auto& Pair : Value)
+			{
+				auto NewData = CastToPsData(Pair.Value);
+				FPsDataFriend::ChangeDataName(NewData, Pair.Key, Field->Name);
+				FPsDataFriend::AttachChild(GetOwner(), NewData);
+			}
+		}
+	}
 };
 
 /***********************************
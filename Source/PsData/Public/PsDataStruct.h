@@ -26,6 +26,9 @@ public:
 	virtual FProperty* CustomFindProperty(const FName Name) const override;
 	virtual void InitializeStruct(void* Dest, int32 ArrayDim = 1) const override;
 
+	/** Find property by serialized field name (including super struct properties) */
+	FProperty* FindPropertyByKey(const FString& Key) const;
+
 protected:
 	void Finalize(uint8* DefaultStruct);
 
@@ -33,4 +36,6 @@ protected:
 
 private:
 	uint8* RawStruct;
+
+	TMap<FString, FProperty*> PropertiesByKey;
 };
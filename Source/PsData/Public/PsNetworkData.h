@@ -3,6 +3,8 @@
 #pragma once
 
 #include "PsData.h"
+#include "PsDataProperty.h"
+#include "Serialize/PsDataDeserializeJob.h"
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
@@ -15,6 +17,9 @@ class APlayerController;
 
 DEFINE_LOG_CATEGORY_STATIC(LogDataNetwork, VeryVerbose, All);
 
+/** Returns false if the data node and its subtree aren't needed by the connection of the controller */
+DECLARE_DELEGATE_RetVal_TwoParams(bool, FPsNetworkRelevancyDelegate, const UPsData*, const APlayerController*);
+
 /***********************************
  * FPsNetworkByteBuffer
  ***********************************/
@@ -43,6 +48,7 @@ enum class EPsNetworkEventType : uint8
 	Changed = 1,
 	Added = 2,
 	Removed = 3,
+	ChangedElements = 4,
 };
 
 /***********************************
@@ -55,10 +61,13 @@ struct FPsNetworkEvent
 	GENERATED_BODY()
 
 	FPsNetworkEvent();
-	FPsNetworkEvent(EPsNetworkEventType InType, const FString& InPath, const TArray<uint8>& InBuffer);
+	FPsNetworkEvent(EPsNetworkEventType InType, const TArray<uint32>& InPath, const TArray<uint8>& InBuffer);
 
 	EPsNetworkEventType Type;
-	FString Path;
+
+	/** Field indices from the network data, each container field is followed by an array index or an id of the map key */
+	TArray<uint32> Path;
+
 	FPsNetworkByteBuffer Data;
 
 	bool Serialize(FArchive& Ar);
@@ -79,14 +88,26 @@ struct FPsNetworkEventBundle
 
 	FPsNetworkEventBundle();
 
-	void AddEvent(EPsNetworkEventType InType, const FString& InPath, const TArray<uint8>& InBuffer);
+	void AddEvent(EPsNetworkEventType InType, const TArray<uint32>& InPath, const TArray<uint8>& InBuffer);
 
-	TArray<FPsNetworkEvent> GetBundle() const;
+	void AddKey(const FString& InKey);
+
+	const TArray<FPsNetworkEvent>& GetBundle() const;
+
+	const TArray<FString>& GetKeys() const;
 
 	void Reset();
 
 	bool HasEvents() const;
 
+	bool IsEmpty() const;
+
+	/** Serialize the keys and the events once, the payload is reused by the RPCs of all proxies until the bundle is changed */
+	void Seal();
+
+	/** Size of the sealed payload in bytes */
+	int32 GetPayloadSize();
+
 	bool Serialize(FArchive& Ar);
 	bool Serialize(FStructuredArchive::FSlot Slot);
 	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
@@ -94,7 +115,58 @@ struct FPsNetworkEventBundle
 	friend void operator<<(FStructuredArchive::FSlot Slot, FPsNetworkEventBundle& Value);
 
 private:
+	/** Read the keys and the events from the payload bytes, false if they are malformed */
+	bool LoadPayload(const TArray<uint8>& Bytes);
+
+	/** Map keys used by the events for the first time, their ids continue the ids of the previous bundles */
+	TArray<FString> Keys;
+
 	TArray<FPsNetworkEvent> Events;
+
+	TSharedPtr<const TArray<uint8>> Payload;
+};
+
+/***********************************
+ * FPsNetworkPendingEvent
+ ***********************************/
+
+/** Added or removed event committed since the last flush */
+struct FPsNetworkPendingEvent
+{
+	EPsNetworkEventType Type;
+	TArray<uint32> Path;
+	TArray<uint8> Buffer;
+	const UPsData* Data;
+
+	/** Data which collection or property is changed by the event */
+	TWeakObjectPtr<const UPsData> Owner;
+};
+
+/** Field changed since the last flush */
+struct FPsNetworkPendingChange
+{
+	TWeakObjectPtr<const UPsData> Data;
+
+	/** Element operations of a container, valid until the whole value has to be sent */
+	PsDataTools::FDataContainerDelta Delta;
+
+	bool bFullValue;
+
+	/** Number of flushes the change was deferred by the budget, added to the priority of the field */
+	int32 Age;
+};
+
+/***********************************
+ * FPsNetworkPathCache
+ ***********************************/
+
+/** Data resolved for the last event path, the events of a bundle mostly share their path prefixes */
+struct FPsNetworkPathCache
+{
+	TArray<uint32> Path;
+
+	/** Resolved data with the offset of its first token in the path */
+	TArray<TPair<int32, UPsData*>> Nodes;
 };
 
 /***********************************
@@ -127,26 +199,70 @@ public:
 protected:
 	friend class UPsNetworkData;
 
+	virtual void PostNetInit() override;
+
+	virtual void OnRep_Owner() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	void Open(UPsNetworkData* InParent);
 
 	void Close();
 
-	void Synchronize(const FPsNetworkByteBuffer& Buffer);
+	void Synchronize(const TSharedRef<const TArray<uint8>>& Buffer, const TArray<FString>& Keys, bool bResync);
+
+	void SendSynchronizeChunks(float DeltaTime);
+
+	void OnSynchronizeCompleted();
+
+	/** Ask the server for the full snapshot again, the events received until it arrives are dropped (client only) */
+	void RequestSynchronize();
+
+	/** Drop everything in flight, the client gets a new snapshot on the next flush (server only) */
+	void ResetSynchronize();
 
 	void Send(const FPsNetworkEventBundle& Events);
 
 private:
 	UFUNCTION(Server, Reliable)
-	void Server_Confirm();
+	void Server_Confirm(const FPsNetworkByteBuffer& Hashes);
 
 	UFUNCTION(Client, Reliable)
-	void Client_Synchronize(const FPsNetworkByteBuffer& Buffer);
+	void Client_BeginSynchronize(int32 Size, const TArray<FString>& Keys, bool bResync);
+
+	UFUNCTION(Client, Reliable)
+	void Client_SynchronizeChunk(const FPsNetworkByteBuffer& Chunk);
 
 	UFUNCTION(Client, Reliable)
 	void Client_Send(const FPsNetworkEventBundle& Events);
 
 	EProxyState State;
 
+	/** Subtree hashes of the client data by path (server only), empty if the client needs the full snapshot */
+	TMap<FString, FString> ClientHashes;
+
+	/** Snapshot being sent in chunks, shared by the proxies synchronized in the same flush (server only) */
+	TSharedPtr<const TArray<uint8>> SynchronizePayload;
+
+	/** Number of the sent bytes of the snapshot (server only) */
+	int32 SynchronizeOffset;
+
+	/** Snapshot being received in chunks (client only) */
+	TArray<uint8> SynchronizeBuffer;
+
+	/** Full size of the received snapshot, INDEX_NONE if no snapshot is expected (client only) */
+	int32 SynchronizeSize;
+
+	TArray<FString> SynchronizeKeys;
+
+	bool bSynchronizeResync;
+
+	/** Bundles sent after the snapshot is sent completely, paced by the connection like the chunks (server only) */
+	TArray<FPsNetworkEventBundle> QueuedBundles;
+
+	/** Topmost subtrees irrelevant for the connection which events were dropped (server only) */
+	TSet<TWeakObjectPtr<const UPsData>> HiddenData;
+
 	UPROPERTY()
 	UPsNetworkData* NetworkData;
 };
@@ -166,6 +282,27 @@ public:
 	/** How often (per second) this data will be considered for replication */
 	float NetUpdateFrequency;
 
+	/** Size of the changed values per flush in bytes, the rest waits for the next flushes by NetPriority and age; zero is unlimited */
+	int32 NetBudget;
+
+	/** Time budget per frame (microseconds) to apply the initial snapshot on the client, zero applies it at once */
+	int32 SynchronizeBudget;
+
+	/** Size of a chunk of the initial snapshot in bytes, the chunks are paced by the speed of the connection */
+	int32 SynchronizeChunkSize;
+
+	/** Depth of the data subtrees compared by hash on (re)connect, the client then keeps its data between connections; zero (default) resets the data and sends the full snapshot */
+	int32 ResyncDepth;
+
+	/** Number of the map keys of the event paths after which the clients are resynchronized with a new key dictionary; zero is unlimited */
+	int32 MaxPathKeys;
+
+	/** Number of the bundles queued behind a snapshot after which the client gets a new snapshot instead; zero is unlimited */
+	int32 MaxQueuedBundles;
+
+	/** Filter of the events per connection, the root is always relevant; unbound sends all events to all connections */
+	FPsNetworkRelevancyDelegate RelevancyDelegate;
+
 	void OpenConnection(APlayerController* Controller) const;
 
 	void CloseConnection(APlayerController* Controller) const;
@@ -186,21 +323,53 @@ private:
 
 	virtual TStatId GetStatId() const override;
 
-	void CommitChanges(const UPsData* Data, const FDataField* Field);
+	void CommitChanges(const UPsData* Data, const FDataField* Field, const FPsDataDeltaWriter* DeltaWriter);
 
 	void CommitAddedEvent(const UPsData* Data);
 
 	void CommitRemovingEvent(const UPsData* Data);
 
+	bool CancelAddedEvent(const UPsData* Data);
+
+	void BuildNetworkEvents();
+
+	void SendNetworkEvents(const TArray<ADataNetworkActor*>& Proxies);
+
+	const UPsData* FindHiddenData(const UPsData* Data, const APlayerController* Controller, TMap<const UPsData*, const UPsData*>& Cache) const;
+
+	void EncodePath(const UPsData* Data, TArray<uint32>& OutPath);
+
+	bool ResolvePath(const TArray<uint32>& Path, FPsNetworkPathCache& Cache, FAbstractDataProperty*& OutProperty, FString& OutKey) const;
+
 	void HandlingControllers();
 
-	void Synchronize(const FPsNetworkByteBuffer& Buffer);
+	void OpenProxy(APlayerController* Controller, ADataNetworkActor* Proxy) const;
+
+	static void RegisterProxy(ADataNetworkActor* Proxy);
+
+	static void UnregisterProxy(ADataNetworkActor* Proxy);
+
+	FPsNetworkByteBuffer CollectHashes() const;
+
+	void CollectHashes(const UPsData* Data, int32 Depth, FPsDataOutputStream& OutputStream) const;
+
+	TSharedRef<const TArray<uint8>> SerializeResync(const TMap<FString, FString>& Hashes) const;
+
+	void SerializeResync(const UPsData* Data, int32 Depth, const TMap<FString, FString>& Hashes, FPsDataSerializer* Serializer) const;
+
+	void Synchronize(const FPsNetworkByteBuffer& Buffer, const TArray<FString>& Keys, bool bResync);
+
+	void OnSynchronizeCompleted();
+
+	void RequestSynchronize();
 
 	void Apply(const FPsNetworkEventBundle& Events);
 
-	bool ApplyChanged(FAbstractDataProperty* Property, const FPsNetworkByteBuffer& Buffer) const;
+	bool ApplyChanged(FAbstractDataProperty* Property, FPsDataBinaryDeserializer* Deserializer) const;
 
-	bool ApplyAddedEvent(FAbstractDataProperty* Property, const FString& Key, const FPsNetworkByteBuffer& Buffer) const;
+	bool ApplyChangedElements(FAbstractDataProperty* Property, FPsDataBinaryDeserializer* Deserializer) const;
+
+	bool ApplyAddedEvent(FAbstractDataProperty* Property, const FString& Key, FPsDataBinaryDeserializer* Deserializer) const;
 
 	bool ApplyRemovingEvent(FAbstractDataProperty* Property, const FString& Key) const;
 
@@ -208,6 +377,27 @@ private:
 
 	FPsNetworkEventBundle NetworkEvents;
 
+	/** Data changed by the events of the bundle, used to filter the events per connection */
+	TArray<TWeakObjectPtr<const UPsData>> NetworkEventOwners;
+
+	/** Data added by the events of the bundle (null for the other events), the added subtree is filtered by itself */
+	TArray<TWeakObjectPtr<const UPsData>> NetworkEventAddedData;
+
+	/** Added and removed events since the last flush in the commit order */
+	TArray<FPsNetworkPendingEvent> PendingEvents;
+
+	/** Fields changed since the last flush, the values are serialized once at flush time */
+	TMap<TPair<const UPsData*, const FDataField*>, FPsNetworkPendingChange> PendingChanges;
+
+	/** Map keys of the event paths by id, the client gets them with the snapshot and the bundles */
+	mutable TArray<FString> PathKeys;
+
+	/** Ids of the map keys (server only) */
+	TMap<FString, uint32> PathKeyIds;
+
+	/** Number of the map keys sent with the bundles */
+	int32 NumSentPathKeys;
+
 	float AccumulatedTime;
 
 	mutable int32 NumAuthorityProxies;
@@ -217,8 +407,19 @@ private:
 	UPROPERTY()
 	mutable TArray<APlayerController*> PendingControllers;
 
+	/** Client proxies replicated before their connection is opened, by owning controller */
+	static TMap<TWeakObjectPtr<const APlayerController>, TWeakObjectPtr<ADataNetworkActor>> RegisteredProxies;
+
+	/** Network data waiting for the proxy of the controller */
+	static TMap<TWeakObjectPtr<const APlayerController>, TWeakObjectPtr<UPsNetworkData>> PendingNetworks;
+
 	UPROPERTY()
 	mutable TArray<ADataNetworkActor*> NetworkProxies;
 
 	mutable FPsDataSimplePromise SynchronizePromise;
+
+	TSharedPtr<FPsDataDeserializeJob> SynchronizeJob;
+
+	/** Events received while the snapshot is being applied */
+	TArray<FPsNetworkEventBundle> PendingBundles;
 };
@@ -4,9 +4,10 @@
 
 #include "Serialize/PsDataBinarySerialization.h"
 #include "Serialize/PsDataSerialization.h"
+#include "Serialize/Stream/PsDataChunkedOutputStream.h"
 #include "Serialize/Stream/PsDataMD5OutputStream.h"
-#include "Stream/PsDataBufferInputStream.h"
 #include "Stream/PsDataBufferOutputStream.h"
+#include "Stream/PsDataInputStream.h"
 
 #include "CoreMinimal.h"
 
@@ -64,7 +65,11 @@ private:
 
 struct FPsDataImprintBinarySerializer : public FPsDataBinarySerializer
 {
-	static uint32 Concatenate(TSharedRef<FPsDataBufferOutputStream>& OutputStream, const UPsData* Data);
+	/** Size of the child placeholder that is replaced by redirect on concatenation */
+	static constexpr int32 RedirectSlotSize = 5;
+
+	/** Concatenate imprints of the data tree, imprint buffers are referenced by the stream and must outlive it */
+	static uint32 Concatenate(TSharedRef<FPsDataChunkedOutputStream>& OutputStream, const UPsData* Data);
 
 	FPsDataImprintBinarySerializer(FPsDataImprint* InImprint);
 	virtual ~FPsDataImprintBinarySerializer() override {}
@@ -81,11 +86,14 @@ protected:
 
 struct FPsDataImprintBinaryDeserializer : public FPsDataBinaryDeserializer
 {
-	FPsDataImprintBinaryDeserializer(TSharedRef<FPsDataBufferInputStream> InInputStream, int32 InOffset);
+	FPsDataImprintBinaryDeserializer(TSharedRef<FPsDataInputStream> InInputStream, int32 InOffset);
 	virtual ~FPsDataImprintBinaryDeserializer() override {}
 
 	virtual uint8 ReadToken() override;
 
+	/** Elements can share redirected parts, so they aren't split */
+	virtual bool SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements) override;
+
 protected:
 	bool TryToRedirect(uint8 Token);
 
@@ -112,6 +120,8 @@ protected:
 	void PopObject(FPsDataSerializer* Serializer);
 
 	void ReadNull(FPsDataSerializer* Serializer);
+	void ReadDeleted(FPsDataSerializer* Serializer);
+	void ReadTypedArray(FPsDataSerializer* Serializer);
 
 	template <typename T>
 	void ReadValue(FPsDataSerializer* Serializer)
@@ -121,6 +131,14 @@ protected:
 		Serializer->WriteValue(Value);
 	}
 
+	template <typename T>
+	void ReadValues(FPsDataSerializer* Serializer)
+	{
+		TArray<T> Values;
+		Deserializer->ReadValues(Values);
+		Serializer->WriteValues(Values);
+	}
+
 	FPsDataImprintBinaryDeserializer* Deserializer;
 	TArray<FString> Keys;
 };
@@ -27,6 +27,8 @@ constexpr uint8 ArrayEnd = ']';   // 93
 constexpr uint8 ObjectBegin = '{'; // 123
 constexpr uint8 ObjectEnd = '}';   // 125
 
+constexpr uint8 TypedArray = '<'; // 60
+
 constexpr uint8 Value_uint8 = 'A';  // 65
 constexpr uint8 Value_int8 = 'B';   // 66
 constexpr uint8 Value_uint16 = 'C'; // 67
@@ -43,6 +45,8 @@ constexpr uint8 Value_bool = 'b';    // 98
 constexpr uint8 Value_FString = 'c'; // 99
 constexpr uint8 Value_FName = 'd';   // 100
 
+constexpr uint8 Deleted = 'z'; // 122
+
 constexpr uint8 Redirect = 26;    // 26
 constexpr uint8 RedirectEnd = 10; // 10
 } // namespace EBinaryTokens
@@ -74,9 +78,22 @@ public:
 	virtual void WriteValue(const FName& Value) override;
 	virtual void WriteValue(const UPsData* Value) override;
 
+	virtual void WriteValues(const TArray<int32>& Values) override;
+	virtual void WriteValues(const TArray<int64>& Values) override;
+	virtual void WriteValues(const TArray<uint8>& Values) override;
+	virtual void WriteValues(const TArray<float>& Values) override;
+	virtual void WriteValues(const TArray<bool>& Values) override;
+
+	virtual void WriteDeleted() override;
+	virtual bool WriteBinaryValue(const TArray<uint8>& Bytes) override;
+
 	virtual void PopKey(const FString& Key) override;
 	virtual void PopArray() override;
 	virtual void PopObject() override;
+
+protected:
+	template <typename T>
+	void WriteTypedArray(uint8 ElementToken, const TArray<T>& Values);
 };
 
 /***********************************
@@ -110,8 +127,32 @@ public:
 	virtual bool ReadValue(FName& OutValue) override;
 	virtual bool ReadValue(UPsData*& OutValue, FPsDataAllocator Allocator) override;
 
+	virtual bool ReadValues(TArray<int32>& OutValues) override;
+	virtual bool ReadValues(TArray<int64>& OutValues) override;
+	virtual bool ReadValues(TArray<uint8>& OutValues) override;
+	virtual bool ReadValues(TArray<float>& OutValues) override;
+	virtual bool ReadValues(TArray<bool>& OutValues) override;
+
+	/** Element token of the typed array at the current position or Null */
+	uint8 PeekTypedArrayToken();
+
+	/** Skip the value at the current position, returns false if there is no value */
+	bool SkipValue();
+
+	/** Copy the value at the current position to the serializer token by token (skip it if the serializer is nullptr) */
+	bool CopyValue(FPsDataSerializer* Serializer);
+
+	virtual TSharedPtr<const TArray<uint8>> ReadBinaryValue() override;
+
+	virtual bool SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements) override;
+	virtual bool ReadDeleted() override;
+
 	virtual void PopKey(const FString& Key) override;
 	virtual void PopIndex() override;
 	virtual void PopArray() override;
 	virtual void PopObject() override;
+
+protected:
+	template <typename T>
+	bool ReadTypedArray(uint8 ElementToken, TArray<T>& OutValues);
 };
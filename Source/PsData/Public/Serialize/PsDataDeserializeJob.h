@@ -0,0 +1,89 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "PsDataEvent.h"
+#include "PsDataPromise.h"
+#include "Serialize/PsDataBinarySerialization.h"
+
+#include "Containers/Ticker.h"
+#include "CoreMinimal.h"
+
+class UPsData;
+
+/***********************************
+ * FPsDataDeserializeJob
+ ***********************************/
+
+/**
+ * Resumable deserialization of a binary snapshot (plain, imprint or compressed).
+ * The snapshot is parsed off the game thread into a flat token tape, the tape is applied to the data in slices
+ * bounded by a time budget per frame. Events of the whole job are held back until completion, so other data changes
+ * made while the job is running are deferred as well. The job is cancelled when the last reference is released.
+ */
+struct PSDATA_API FPsDataDeserializeJob : public TSharedFromThis<FPsDataDeserializeJob>
+{
+private:
+	struct FFrame
+	{
+		TWeakObjectPtr<UPsData> Data;
+		FString Key;
+	};
+
+	enum class EState : uint8
+	{
+		Parsing,
+		Applying,
+		Completed,
+		Failed
+	};
+
+public:
+	/** Default time budget per frame in microseconds */
+	static constexpr int32 DefaultBudget = 2000;
+
+	/** Start the job, Offset is the start offset of an imprint snapshot, bParallelCollections is passed to the deserializer */
+	static TSharedRef<FPsDataDeserializeJob> Start(UPsData* Data, TSharedRef<TArray<uint8>> Buffer, int32 Offset = 0, bool bPatch = false, int32 Budget = DefaultBudget, bool bParallelCollections = false);
+
+	FPsDataDeserializeJob(UPsData* InData, bool bInPatch, int32 InBudget, bool bInParallelCollections = false);
+	~FPsDataDeserializeJob();
+
+	/** Stop applying, the data keeps the values applied so far */
+	void Cancel();
+
+	bool IsCompleted() const;
+	bool IsFailed() const;
+
+	/** Applied share of the tape from 0 to 1 */
+	float GetProgress() const;
+
+	/** Resolved when the tape is parsed and the job starts applying it */
+	FPsDataSimplePromise& OnParsedPromise();
+
+	/** Resolved when the job is completed, failed or cancelled */
+	FPsDataSimplePromise& OnCompletedPromise();
+
+private:
+	/** Runs on a worker without the job, so the job is always released and finished on the game thread */
+	static TSharedRef<TArray<uint8>> Parse(TSharedRef<TArray<uint8>> Buffer, int32 Offset);
+	void BeginApply(TSharedRef<TArray<uint8>> InTape);
+	bool Tick(float DeltaTime);
+	bool Step();
+	void Finish(EState NewState);
+
+	TWeakObjectPtr<UPsData> Data;
+	bool bPatch;
+	bool bParallelCollections;
+	int32 Budget;
+	EState State;
+
+	TSharedPtr<TArray<uint8>> Tape;
+	TUniquePtr<FPsDataBinaryDeserializer> Deserializer;
+	TArray<FFrame> Stack;
+
+	TUniquePtr<FPsDataEventScopeGuard> EventScopeGuard;
+	FDelegateHandle TickerHandle;
+
+	FPsDataSimplePromise ParsedPromise;
+	FPsDataSimplePromise CompletedPromise;
+};
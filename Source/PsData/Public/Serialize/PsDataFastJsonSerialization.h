@@ -101,9 +101,13 @@ public:
 	virtual ~FPsDataFastJsonDeserializer(){};
 
 private:
+	/** Deserializer of a single element, it shares the parsed pointers of the parent */
+	FPsDataFastJsonDeserializer(const TCHAR* InSource, int32 InSize, TArray<FPsDataFastJsonPointer>& InPointers, int32 InPointerIndex);
+
 	const TCHAR* Source;
 	int32 Size;
-	TArray<FPsDataFastJsonPointer> Pointers;
+	TArray<FPsDataFastJsonPointer> OwnPointers;
+	TArray<FPsDataFastJsonPointer>& Pointers;
 	int32 PointerIndex;
 	TArray<int32> DepthStack;
 
@@ -124,6 +128,8 @@ public:
 	virtual bool ReadValue(FName& OutValue) override;
 	virtual bool ReadValue(UPsData*& OutValue, FPsDataAllocator Allocator) override;
 
+	virtual bool SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements) override;
+
 	virtual void PopKey(const FString& Key) override;
 	virtual void PopIndex() override;
 	virtual void PopArray() override;
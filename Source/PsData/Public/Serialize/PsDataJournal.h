@@ -0,0 +1,108 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Ticker.h"
+#include "CoreMinimal.h"
+
+class UPsData;
+struct FPsDataDeserializer;
+struct FPsDataViewInputStream;
+struct FAbstractDataProperty;
+struct FDataField;
+
+/***********************************
+ * FPsDataJournal
+ ***********************************/
+
+/**
+ * Write-ahead journal of the data changes on top of the last full snapshot.
+ * Field changes and added/removed children are recorded at the same points as the network events and appended
+ * to the journal file in batches off the game thread. The snapshot and the journal are stored as Filename and Filename.journal,
+ * the journal is compacted into a new snapshot when it grows over CompactionSize.
+ * A new snapshot is written to Filename.tmp and renamed over the old one, Load restores it if the rename was interrupted.
+ * The journal is truncated only after the new snapshot is in place, so a failed compaction keeps the old snapshot and journal.
+ */
+struct PSDATA_API FPsDataJournal : public TSharedFromThis<FPsDataJournal>
+{
+private:
+	enum class ERecordType : uint8
+	{
+		Changed = 1,
+		Added = 2,
+		Removed = 3
+	};
+
+	/** File writes are run one by one in the order of the calls */
+	struct FWriter : public TSharedFromThis<FWriter>
+	{
+		void Enqueue(TFunction<void()>&& Task);
+		void Drain();
+
+		FCriticalSection CriticalSection;
+		TArray<TFunction<void()>> Tasks;
+		bool bRunning = false;
+
+		/** Generation of the snapshot on the disk, it's only changed by the tasks after the snapshot is replaced */
+		uint32 Generation = 0;
+	};
+
+public:
+	/** Default interval between batches in seconds */
+	static constexpr float DefaultFlushInterval = 0.5f;
+
+	/** Default size of the journal in bytes after which it's compacted */
+	static constexpr int32 DefaultCompactionSize = 4 * 1024 * 1024;
+
+	FPsDataJournal(UPsData* InData, const FString& InFilename);
+	~FPsDataJournal();
+
+	float FlushInterval;
+	int32 CompactionSize;
+
+	/** Load the snapshot and replay the journal on top of it, returns false if there is no valid snapshot */
+	bool Load();
+
+	/** Start recording the changes of the data, a new snapshot is written if it wasn't loaded */
+	void Attach();
+
+	/** Stop recording, the recorded changes are flushed */
+	void Detach();
+
+	bool IsAttached() const;
+
+	/** Append the recorded changes to the journal */
+	void Flush();
+
+	/** Write a new snapshot of the data and truncate the journal */
+	void Compact();
+
+private:
+	friend class UPsData;
+
+	void CommitChanges(const UPsData* Target, const FDataField* Field);
+	void CommitAddedEvent(const UPsData* Target);
+	void CommitRemovingEvent(const UPsData* Target);
+	void AddRecord(ERecordType Type, const FString& Path, const TArray<uint8>& Buffer);
+	void AppendBatch();
+
+	bool Tick(float DeltaTime);
+	int32 Replay(const TArray<uint8>& Buffer);
+	bool ApplyRecord(FPsDataViewInputStream& InputStream);
+	bool ApplyAddedEvent(FAbstractDataProperty* Property, const FString& Key, FPsDataDeserializer* Deserializer) const;
+	bool ApplyRemovingEvent(FAbstractDataProperty* Property, const FString& Key) const;
+	void ResetJournal();
+
+	TWeakObjectPtr<UPsData> Data;
+	FString Filename;
+	FString JournalFilename;
+
+	int32 JournalSize;
+	bool bSnapshot;
+	bool bAttached;
+	bool bReplaying;
+
+	TArray<uint8> PendingRecords;
+	TSharedRef<FWriter> Writer;
+	FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,88 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+class UPsData;
+struct FDataField;
+struct FPsDataViewInputStream;
+
+/***********************************
+ * FPsDataSaveContainer
+ ***********************************/
+
+/**
+ * Save file with separately addressable blocks of the data tree.
+ * Data under single data properties is split into blocks down to SplitDepth, the path of a block is the path from the saved data.
+ * A block at SplitDepth holds the whole subtree, a block above it holds the data without the split children.
+ * Blocks and the index are appended to the end of the file, unchanged blocks aren't written again.
+ * Compaction writes Filename.tmp and renames it over the file, Open restores the file from it if the rename was interrupted.
+ */
+struct PSDATA_API FPsDataSaveContainer
+{
+private:
+	struct FEntry
+	{
+		uint32 Offset;
+		uint32 Size;
+		FString Hash;
+		bool bSubtree;
+	};
+
+	struct FBlock
+	{
+		FString Path;
+		const UPsData* Data;
+		const FDataField* Field;
+		FString Hash;
+		TArray<uint8> Bytes;
+	};
+
+public:
+	FPsDataSaveContainer(const FString& InFilename, int32 InSplitDepth = 1);
+
+	/** Share of the dead bytes relative to the live ones, after which the file is compacted on save */
+	float CompactionRatio;
+
+	/** Read the index of the existing file, returns false if the file isn't a valid container (called by the first save if needed) */
+	bool Open();
+
+	/** Write the changed blocks of the data */
+	bool Save(const UPsData* Data);
+
+	/** Write the block with the path if it's changed */
+	bool SaveBlock(const UPsData* Data, const FString& Path);
+
+	/** Load all blocks into the data */
+	bool Load(UPsData* Data);
+
+	/** Load the block with the path into the data, the rest of the data isn't touched */
+	bool LoadBlock(UPsData* Data, const FString& Path);
+
+	/** Rewrite the file with the live blocks only */
+	bool Compact();
+
+	/** Paths of the blocks in the file */
+	TArray<FString> GetPaths() const;
+
+	/** Number of the dead bytes in the file */
+	int32 GetGarbageSize() const;
+
+private:
+	void CollectBlocks(const UPsData* Root, const UPsData* Data, int32 Depth, TArray<FBlock>& OutBlocks) const;
+	void HashBlock(FBlock& Block) const;
+	void SerializeBlock(FBlock& Block) const;
+	bool WriteBlocks(TArray<FBlock>& Blocks, const TSet<FString>& LivePaths);
+	bool ReadBlock(IFileHandle& Handle, const FEntry& Entry, TArray<uint8>& OutBytes) const;
+	bool ApplyBlock(UPsData* Data, const FString& Path, const FEntry& Entry, const TArray<uint8>& Bytes) const;
+	static TArray<uint8> WriteIndex(const TMap<FString, FEntry>& Entries, uint32 IndexOffset);
+	static bool ReadIndexEntry(FPsDataViewInputStream& Stream, uint32 IndexOffset, FString& OutPath, FEntry& OutEntry);
+
+	FString Filename;
+	int32 SplitDepth;
+	TMap<FString, FEntry> Index;
+	int32 FileSize;
+	int32 LiveSize;
+};
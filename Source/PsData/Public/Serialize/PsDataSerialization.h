@@ -49,6 +49,19 @@ public:
 	virtual void WriteValue(const FName& Value) = 0;
 	virtual void WriteValue(const UPsData* Value) = 0;
 
+	/** Write scalar array as a whole (default implementation writes it element by element) */
+	virtual void WriteValues(const TArray<int32>& Values);
+	virtual void WriteValues(const TArray<int64>& Values);
+	virtual void WriteValues(const TArray<uint8>& Values);
+	virtual void WriteValues(const TArray<float>& Values);
+	virtual void WriteValues(const TArray<bool>& Values);
+
+	/** Write deletion marker of a map element in a patch (default implementation writes null) */
+	virtual void WriteDeleted();
+
+	/** Write value kept in the binary format as is, returns false if the serializer can't do it */
+	virtual bool WriteBinaryValue(const TArray<uint8>& Bytes);
+
 	virtual void PopKey(const FString& Key) = 0;
 	virtual void PopArray() = 0;
 	virtual void PopObject() = 0;
@@ -62,6 +75,17 @@ struct PSDATA_API FPsDataDeserializer
 {
 public:
 	FPsDataDeserializer();
+	virtual ~FPsDataDeserializer() {}
+
+	/**
+	 * Allow collections of data to be filled in parallel (see SplitElements).
+	 * New elements are filled on worker threads: their Changed() (and the DeferredTask it queues) and PostDeserialize run there,
+	 * so PostDeserialize overrides of the element classes must be thread-safe.
+	 */
+	bool bParallelCollections;
+
+	/** Maps are changed in place, only keys of the patch are touched */
+	bool bPatch;
 
 	virtual bool ReadKey(FString& OutKey) = 0;
 	virtual bool ReadIndex() = 0;
@@ -76,6 +100,25 @@ public:
 	virtual bool ReadValue(FName& OutValue) = 0;
 	virtual bool ReadValue(UPsData*& OutValue, FPsDataAllocator Allocator) = 0;
 
+	/** Read scalar array as a whole (default implementation reads it element by element) */
+	virtual bool ReadValues(TArray<int32>& OutValues);
+	virtual bool ReadValues(TArray<int64>& OutValues);
+	virtual bool ReadValues(TArray<uint8>& OutValues);
+	virtual bool ReadValues(TArray<float>& OutValues);
+	virtual bool ReadValues(TArray<bool>& OutValues);
+
+	/**
+	 * Split the rest of the opened object or array into independent deserializers, one per element, and move to its end.
+	 * OutKeys is nullptr for arrays. Default implementation can't split and returns false without reading anything.
+	 */
+	virtual bool SplitElements(TArray<FString>* OutKeys, TArray<TUniquePtr<FPsDataDeserializer>>& OutElements);
+
+	/** Read deletion marker of a map element in a patch (default implementation doesn't support it) */
+	virtual bool ReadDeleted();
+
+	/** Read the value at the current position in the binary format without deserializing it (nullptr if not supported) */
+	virtual TSharedPtr<const TArray<uint8>> ReadBinaryValue();
+
 	virtual void PopKey(const FString& Key) = 0;
 	virtual void PopIndex() = 0;
 	virtual void PopArray() = 0;
@@ -19,41 +19,82 @@ class UPsData;
 struct PSDATA_API FPsDataStructSerializer : public FPsDataSerializer
 {
 private:
-	FPsDataJsonSerializer JsonSerializer;
+	enum class EFrameType : uint8
+	{
+		Object,
+		Array,
+		Map,
+		Value,
+		Skip
+	};
+
+	struct FFrame
+	{
+		EFrameType Type;
+		const FProperty* Property;
+		const UStruct* Struct;
+		uint8* Ptr;
+	};
+
+	const UStruct* Struct;
+	uint8* Raw;
+	bool bOwnRaw;
+	TArray<FFrame> Stack;
+
+	/** Json buffer of the deprecated constructors, the struct is built from it on request */
+	TUniquePtr<FPsDataJsonSerializer> LegacyJson;
 
 public:
-	FPsDataStructSerializer(TSharedPtr<FJsonObject> InRootJson)
-		: FPsDataSerializer()
-		, JsonSerializer(InRootJson)
-	{
-		JsonSerializer.bWriteDefaults = true;
-		bWriteDefaults = true;
-	}
+	/** Serialized data is written directly into the memory of the struct */
+	FPsDataStructSerializer(const UStruct* InStruct, bool bInitialize = true);
+	virtual ~FPsDataStructSerializer();
+
+	PSDATA_DEPRECATED("Json buffering is slow, use FPsDataStructSerializer(const UStruct*, bool) instead")
+	FPsDataStructSerializer(TSharedPtr<FJsonObject> InRootJson);
 
-	FPsDataStructSerializer()
-		: FPsDataSerializer()
+	PSDATA_DEPRECATED("Json buffering is slow, use FPsDataStructSerializer(const UStruct*, bool) instead")
+	FPsDataStructSerializer();
+
+	/** Release struct memory, the caller is responsible for destroying and freeing it */
+	uint8* GetRaw();
+
+	PSDATA_DEPRECATED("Pass the struct to the constructor and use GetRaw() instead")
+	uint8* GetRaw(UStruct* InStruct, bool bInitialize = true);
+
+	template <typename T>
+	T GetStruct() const
 	{
-		JsonSerializer.bWriteDefaults = true;
-		bWriteDefaults = true;
+		if (LegacyJson.IsValid())
+		{
+			return GetLegacyStruct<T>(true);
+		}
+
+		check(T::StaticStruct() == Struct);
+		return *reinterpret_cast<const T*>(Raw);
 	}
 
-	uint8* GetRaw(UStruct* Struct, bool bInitialize = true)
+	template <typename T>
+	PSDATA_DEPRECATED("Pass the struct to the constructor and use GetStruct() instead")
+	T GetStruct(bool bInitialize)
 	{
-		return CreateStructFromJson(Struct, JsonSerializer.GetJson().ToSharedRef(), bInitialize);
+		return GetLegacyStruct<T>(bInitialize);
 	}
 
+private:
+	FFrame TakeValueFrame();
+
+	uint8* GetLegacyRaw(const UStruct* InStruct, bool bInitialize) const;
+
 	template <typename T>
-	T GetStruct(bool bInitialize = true)
+	T GetLegacyStruct(bool bInitialize) const
 	{
-		T Result;
-		void* Raw = GetRaw(T::StaticStruct(), bInitialize);
-		Result = *static_cast<T*>(Raw);
-		FMemory::Free(Raw);
+		uint8* LegacyRaw = GetLegacyRaw(T::StaticStruct(), bInitialize);
+		T Result = *reinterpret_cast<const T*>(LegacyRaw);
+		T::StaticStruct()->DestroyStruct(LegacyRaw);
+		FMemory::Free(LegacyRaw);
 		return Result;
 	}
 
-	virtual ~FPsDataStructSerializer(){};
-
 public:
 	virtual void WriteKey(const FString& Key) override;
 	virtual void WriteArray() override;
@@ -78,9 +119,13 @@ public:
 	static uint8* CreateStructFromJson(const UStruct* Struct, const TSharedRef<FJsonObject>& JsonObject, bool bInitialize = true);
 	static uint8* CreateStructFromJson_Import(const UStruct* Struct, const TSharedRef<FJsonObject>& JsonObject, TArray<FString>& ImportProblems);
 
+	/** Struct has only numbers, enums, strings, names and containers of them, so it can be converted off the game thread */
+	static bool IsPlainStruct(const UStruct* Struct);
+
 private:
-	static void PropertyDeserialize(FProperty* Property, uint8* OutDest, const TSharedRef<FJsonValue>& JsonValue);
-	static void StructDeserialize(const UStruct* Struct, uint8* OutDest, const TSharedRef<FJsonObject>& JsonObject, bool bInitialize);
+	static bool IsPlainProperty(const FProperty* Property);
+	static bool PropertyDeserialize(FProperty* Property, uint8* OutDest, const TSharedRef<FJsonValue>& JsonValue);
+	static bool StructDeserialize(const UStruct* Struct, uint8* OutDest, const TSharedRef<FJsonObject>& JsonObject, bool bInitialize);
 
 	static TSharedPtr<FJsonValue> FindJsonValueByProperty(const FProperty* Property, const TSharedRef<FJsonObject>& JsonObject);
 };
@@ -92,24 +137,40 @@ private:
 struct PSDATA_API FPsDataStructDeserializer : public FPsDataDeserializer
 {
 private:
-	FPsDataJsonDeserializer JsonDeserializer;
+	enum class EFrameType : uint8
+	{
+		Object,
+		Array,
+		Map
+	};
 
-public:
-	template <typename T>
-	FPsDataStructDeserializer(const T& Struct)
-		: FPsDataDeserializer()
-		, JsonDeserializer(CreateJsonFromStruct(T::StaticStruct(), &Struct))
+	struct FFrame
 	{
-	}
+		EFrameType Type;
+		const FProperty* Property;
+		const FProperty* Current;
+		const uint8* Ptr;
+		int32 Index;
+	};
+
+	const UStruct* Struct;
+	const uint8* Raw;
+	TArray<FFrame> Stack;
 
-	FPsDataStructDeserializer(const UStruct* Struct, const void* Value)
-		: FPsDataDeserializer()
-		, JsonDeserializer(CreateJsonFromStruct(Struct, Value))
+public:
+	/** Data is read directly from the memory of the struct */
+	template <typename T>
+	FPsDataStructDeserializer(const T& Value)
+		: FPsDataStructDeserializer(T::StaticStruct(), &Value)
 	{
 	}
 
+	FPsDataStructDeserializer(const UStruct* InStruct, const void* Value);
 	virtual ~FPsDataStructDeserializer(){};
 
+private:
+	bool GetCurrentValue(const FProperty*& OutProperty, const uint8*& OutPtr) const;
+
 public:
 	virtual bool ReadKey(FString& OutKey) override;
 	virtual bool ReadIndex() override;
@@ -6,6 +6,7 @@
 #include "PsDataDefines.h"
 #include "Serialize/PsDataJsonSerialization.h"
 #include "Serialize/PsDataSerialization.h"
+#include "Serialize/PsDataStructSerialization.h"
 
 #include "CoreMinimal.h"
 #include "Dom/JsonObject.h"
@@ -18,9 +19,17 @@ class UPsData;
  * FPsDataTableSerializer
  ***********************************/
 
+/** Called after each batch of imported rows with (Processed, Total), return false to cancel the import */
+using FPsDataTableImportProgress = TFunction<bool(int32, int32)>;
+
 struct PSDATA_API FPsDataTableSerializer
 {
-	static void CreateTableFromJson_Import(UDataTable* DataTable, const TArray<TSharedPtr<FJsonValue>>& JsonArray, TArray<FString>& ImportProblems);
+	/**
+	 * Rows of plain structs are converted on worker threads, other rows on the game thread.
+	 * Returns false if the import was cancelled or some rows failed to convert, the table is only changed if the import wasn't cancelled.
+	 * RowHashes are the json hashes of the previous import: rows with the same hash keep their memory, the map is updated after the import.
+	 */
+	static bool CreateTableFromJson_Import(UDataTable* DataTable, const TArray<TSharedPtr<FJsonValue>>& JsonArray, TArray<FString>& ImportProblems, FPsDataTableImportProgress Progress = nullptr, TMap<FName, uint32>* RowHashes = nullptr);
 
 private:
 	static void ReportAboutExtraFields(const UScriptStruct* Struct, FName RowName, const TSharedPtr<FJsonObject>& JsonObject, TArray<FString>& ImportProblems);
@@ -33,9 +42,27 @@ private:
 struct PSDATA_API FPsDataTableDeserializer : public FPsDataDeserializer
 {
 private:
-	FPsDataJsonDeserializer JsonDeserializer;
+	struct FRow
+	{
+		FName Name;
+		FString Key;
+		const uint8* Ptr;
+	};
+
+	const UScriptStruct* Struct;
+	FString PropertyName;
+	TArray<FRow> Rows;
+
+	/** Reader of the current row, values are read directly from the row memory */
+	TOptional<FPsDataStructDeserializer> Row;
+
+	int32 Depth;
+	int32 RowDepth;
+	int32 RowIndex;
+	bool bPropertyPopped;
 
 public:
+	/** Table is read as { PropertyName: { RowName: Row } }, without building an intermediate json */
 	FPsDataTableDeserializer(UDataTable* DataTable, const FString& PropertyName);
 
 	template <typename T>
@@ -52,6 +79,9 @@ public:
 
 	virtual ~FPsDataTableDeserializer(){};
 
+private:
+	bool IsRowValue() const;
+
 public:
 	virtual bool ReadKey(FString& OutKey) override;
 	virtual bool ReadIndex() override;
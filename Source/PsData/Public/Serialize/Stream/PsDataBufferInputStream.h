@@ -30,10 +30,12 @@ public:
 	virtual bool ReadBool() override;
 	virtual TCHAR ReadTCHAR() override;
 	virtual FString ReadString() override;
+	virtual void ReadBuffer(uint8* OutBuffer, int32 Count) override;
 	virtual bool HasData() override;
 	virtual void ShiftBack() override;
 	virtual void SetPosition(int32 Value) override;
 	virtual int32 GetPosition() const override;
+	virtual int32 GetSize() const override;
 
 protected:
 	void CheckRange();
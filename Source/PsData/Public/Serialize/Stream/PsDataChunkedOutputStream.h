@@ -0,0 +1,66 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "Serialize/Stream/PsDataOutputStream.h"
+
+#include "CoreMinimal.h"
+
+/***********************************
+ * FPsDataChunkedOutputStream
+ ***********************************/
+
+struct PSDATA_API FPsDataChunkedOutputStream : public FPsDataOutputStream
+{
+public:
+	static constexpr int32 DefaultChunkSize = 64 * 1024;
+
+	FPsDataChunkedOutputStream(int32 InChunkSize = DefaultChunkSize);
+	virtual ~FPsDataChunkedOutputStream() {}
+
+protected:
+	int32 ChunkSize;
+	int32 ChunkIndex;
+	uint8* ChunkCursor;
+	uint8* ChunkEnd;
+	bool bSegmentOpen;
+	int32 TotalSize;
+
+	TArray<TUniquePtr<uint8[]>> Chunks;
+	TArray<TArray<uint8>> OwnedBuffers;
+	TArray<TArrayView<const uint8>> Segments;
+
+public:
+	/** Reset stream, allocated chunks are kept for reuse */
+	void Reset();
+
+	/** Write buffer without copying, the memory must stay valid and unchanged while the stream is in use */
+	void WriteBufferReference(const uint8* Value, int32 Count);
+
+	/** Ordered list of memory spans that make up the stream */
+	const TArray<TArrayView<const uint8>>& GetSegments() const;
+
+	/** Gather stream into a single buffer, the previous content of the buffer is replaced */
+	void CopyTo(TArray<uint8>& OutBuffer) const;
+
+	/** Gather stream into another stream */
+	void CopyTo(FPsDataOutputStream& OutputStream) const;
+
+	virtual void WriteUint32(uint32 Value) override;
+	virtual void WriteInt32(int32 Value) override;
+	virtual void WriteUint64(uint64 Value) override;
+	virtual void WriteInt64(int64 Value) override;
+	virtual void WriteUint8(uint8 Value) override;
+	virtual void WriteFloat(float Value) override;
+	virtual void WriteBool(bool Value) override;
+	virtual void WriteTCHAR(TCHAR Value) override;
+	virtual void WriteString(const FString& Value) override;
+	virtual void WriteBuffer(const TArray<uint8>& Value) override;
+	virtual void WriteBuffer(const uint8* Value, int32 Count) override;
+	virtual void WriteBuffer(TArray<uint8>&& Value) override;
+	virtual int32 Size() const override;
+
+protected:
+	uint8* Allocate(int32 Count);
+	void NextChunk();
+};
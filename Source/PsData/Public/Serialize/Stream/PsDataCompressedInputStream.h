@@ -0,0 +1,31 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "Serialize/Stream/PsDataCompression.h"
+#include "Serialize/Stream/PsDataViewInputStream.h"
+
+#include "CoreMinimal.h"
+
+/***********************************
+ * FPsDataCompressedInputStream
+ ***********************************/
+
+struct PSDATA_API FPsDataCompressedInputStream : public FPsDataViewInputStream
+{
+public:
+	/** Data without compression frame is read as is */
+	FPsDataCompressedInputStream(TArrayView<const uint8> InView);
+	virtual ~FPsDataCompressedInputStream() {}
+
+protected:
+	TArray<uint8> DecompressedBuffer;
+	bool bValid;
+
+public:
+	/** False if compression frame is corrupted */
+	bool IsValid() const;
+
+	/** Read another buffer from the start, the decompression buffer is reused */
+	bool Reset(TArrayView<const uint8> InView);
+};
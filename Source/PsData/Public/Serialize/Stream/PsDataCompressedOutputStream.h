@@ -0,0 +1,28 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "Serialize/Stream/PsDataBufferOutputStream.h"
+#include "Serialize/Stream/PsDataCompression.h"
+
+#include "CoreMinimal.h"
+
+/***********************************
+ * FPsDataCompressedOutputStream
+ ***********************************/
+
+struct PSDATA_API FPsDataCompressedOutputStream : public FPsDataBufferOutputStream
+{
+public:
+	FPsDataCompressedOutputStream(TSharedRef<FPsDataOutputStream> InOutputStream, PsDataTools::Compression::EFormat InFormat = PsDataTools::Compression::GetDefaultFormat(), int32 InThreshold = PsDataTools::Compression::DefaultThreshold);
+	virtual ~FPsDataCompressedOutputStream() {}
+
+protected:
+	TSharedRef<FPsDataOutputStream> OutputStream;
+	PsDataTools::Compression::EFormat Format;
+	int32 Threshold;
+
+public:
+	/** Compress written data into the wrapped stream as a single frame */
+	void Flush();
+};
@@ -0,0 +1,48 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/***********************************
+ * Compression frame
+ ***********************************/
+
+namespace PsDataTools
+{
+namespace Compression
+{
+/** Frame layout: magic (4 bytes), format (uint8), uncompressed size (uint32), compressed size (uint32), payload */
+constexpr uint8 Magic[] = {'P', 'S', 'D', 'Z'};
+constexpr int32 HeaderSize = 13;
+
+/** Data smaller than threshold is stored without frame */
+constexpr int32 DefaultThreshold = 1024;
+
+/** Frames that declare more data are rejected before the buffer is allocated */
+constexpr int32 MaxUncompressedSize = 256 * 1024 * 1024;
+
+enum class EFormat : uint8
+{
+	None = 0,
+	Zlib = 1,
+	Gzip = 2,
+	LZ4 = 3,
+	Oodle = 4,
+};
+
+/** Best format available on the platform */
+PSDATA_API EFormat GetDefaultFormat();
+
+PSDATA_API FName GetFormatName(EFormat Format);
+
+/** Check that data starts with compression frame (binary data never starts with magic) */
+PSDATA_API bool IsFramed(TArrayView<const uint8> Data);
+
+/** Append framed data to buffer, data below threshold or data which can't be compressed is appended as is */
+PSDATA_API void Compress(TArrayView<const uint8> Data, TArray<uint8>& OutBuffer, EFormat Format = GetDefaultFormat(), int32 Threshold = DefaultThreshold);
+
+/** Decompress framed data to buffer, returns false for corrupted frame */
+PSDATA_API bool Decompress(TArrayView<const uint8> Data, TArray<uint8>& OutBuffer);
+} // namespace Compression
+} // namespace PsDataTools
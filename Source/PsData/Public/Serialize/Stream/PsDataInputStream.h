@@ -19,8 +19,15 @@ struct PSDATA_API FPsDataInputStream
 	virtual bool ReadBool() = 0;
 	virtual TCHAR ReadTCHAR() = 0;
 	virtual FString ReadString() = 0;
+	virtual void ReadBuffer(uint8* OutBuffer, int32 Count) = 0;
 	virtual bool HasData() = 0;
 	virtual void ShiftBack() = 0;
 	virtual void SetPosition(int32 Value) = 0;
 	virtual int32 GetPosition() const = 0;
+
+	/** Total size of the stream in bytes */
+	virtual int32 GetSize() const = 0;
+
+	/** Independent stream over the same memory from the current position, it must not outlive this stream (nullptr if not supported) */
+	virtual TSharedPtr<FPsDataInputStream> Fork() const { return nullptr; }
 };
@@ -3,6 +3,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/ByteSwap.h"
+
+namespace PsDataTools
+{
+/** Store value in big-endian order to possibly unaligned memory */
+FORCEINLINE void StoreBigEndian(uint8* Ptr, uint32 Value)
+{
+#if PLATFORM_LITTLE_ENDIAN
+	Value = BYTESWAP_ORDER32(Value);
+#endif
+	FMemory::Memcpy(Ptr, &Value, sizeof(Value));
+}
+
+/** Store value in big-endian order to possibly unaligned memory */
+FORCEINLINE void StoreBigEndian(uint8* Ptr, uint64 Value)
+{
+#if PLATFORM_LITTLE_ENDIAN
+	Value = BYTESWAP_ORDER64(Value);
+#endif
+	FMemory::Memcpy(Ptr, &Value, sizeof(Value));
+}
+} // namespace PsDataTools
 
 /***********************************
  * FPsDataOutputStream
@@ -0,0 +1,88 @@
+// Copyright 2015-2023 MY.GAMES. All Rights Reserved.
+
+#pragma once
+
+#include "PsDataStringView.h"
+#include "Serialize/Stream/PsDataInputStream.h"
+
+#include "Async/MappedFileHandle.h"
+#include "CoreMinimal.h"
+
+/***********************************
+ * FPsDataViewInputStream
+ ***********************************/
+
+struct PSDATA_API FPsDataViewInputStream : public FPsDataInputStream
+{
+public:
+	FPsDataViewInputStream(TArrayView<const uint8> InView);
+	virtual ~FPsDataViewInputStream() {}
+
+	/** Create stream over memory-mapped file (file is read into memory if the platform can't map it) */
+	static TSharedPtr<FPsDataViewInputStream> CreateFromFile(const FString& Filename);
+
+protected:
+	TArrayView<const uint8> View;
+	int32 Index;
+	int32 PrevIndex;
+
+	TUniquePtr<IMappedFileHandle> MappedFileHandle;
+	TUniquePtr<IMappedFileRegion> MappedFileRegion;
+	TArray<uint8> FileBuffer;
+
+public:
+	TArrayView<const uint8> GetView() const;
+
+	/** Check once that Count bytes are available, after that unchecked reads can be used for them */
+	bool CanRead(int32 Count) const;
+
+	FORCEINLINE uint8 ReadUint8Unchecked()
+	{
+		const uint8* Data = View.GetData() + Index;
+		Index += 1;
+		return Data[0];
+	}
+
+	FORCEINLINE uint32 ReadUint32Unchecked()
+	{
+		const uint8* Data = View.GetData() + Index;
+		Index += 4;
+		return (static_cast<uint32>(Data[0]) << 24) | (static_cast<uint32>(Data[1]) << 16) | (static_cast<uint32>(Data[2]) << 8) | static_cast<uint32>(Data[3]);
+	}
+
+	FORCEINLINE uint64 ReadUint64Unchecked()
+	{
+		const uint64 High = ReadUint32Unchecked();
+		const uint64 Low = ReadUint32Unchecked();
+		return (High << 32) | Low;
+	}
+
+	/** Read string without copying, the view points into the stream memory and lives as long as the stream */
+	PsDataTools::FDataStringViewChar ReadStringView();
+
+	/** Read bytes without copying, the view points into the stream memory and lives as long as the stream */
+	TArrayView<const uint8> ReadView(int32 Count);
+
+	/** Read string of untrusted data, returns false without reading if its length exceeds the rest of the stream */
+	bool TryReadString(FString& OutValue);
+
+	virtual uint32 ReadUint32() override;
+	virtual int32 ReadInt32() override;
+	virtual uint64 ReadUint64() override;
+	virtual int64 ReadInt64() override;
+	virtual uint8 ReadUint8() override;
+	virtual float ReadFloat() override;
+	virtual bool ReadBool() override;
+	virtual TCHAR ReadTCHAR() override;
+	virtual FString ReadString() override;
+	virtual void ReadBuffer(uint8* OutBuffer, int32 Count) override;
+	virtual bool HasData() override;
+	virtual void ShiftBack() override;
+	virtual void SetPosition(int32 Value) override;
+	virtual int32 GetPosition() const override;
+	virtual int32 GetSize() const override;
+	virtual TSharedPtr<FPsDataInputStream> Fork() const override;
+
+protected:
+	void CheckRange(int32 Count) const;
+};
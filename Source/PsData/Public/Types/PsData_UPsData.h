@@ -60,6 +60,13 @@ class PSDATA_API UPsDataUPsDataLibrary : public UBlueprintFunctionLibrary
 public:
 	static void TypeSerialize(const UPsData* const Instance, const FDataField* Field, FPsDataSerializer* Serializer, const void* Value);
 	static void* TypeDeserialize(UPsData* Instance, const FDataField* Field, FPsDataDeserializer* Deserializer, void* Value);
+
+	/**
+	 * Deserialize elements of the opened array (OutKeys is nullptr) or map, GetValue returns the current element by index or key.
+	 * New elements of a class without data fields are filled in parallel if the deserializer allows it.
+	 */
+	static void TypeDeserializeElements(UPsData* Instance, const FDataField* Field, FPsDataDeserializer* Deserializer, TArray<FString>* OutKeys, TArray<UPsData*>& OutValues, TFunctionRef<UPsData*(int32, const FString&)> GetValue);
+
 	static bool IsA(const FAbstractDataTypeContext* LeftContext, const FAbstractDataTypeContext* RightContext);
 };
 
@@ -158,4 +165,63 @@ struct TTypeDeserializer<T*>
 		return static_cast<T*>(UPsDataUPsDataLibrary::TypeDeserialize(Instance, Field, Deserializer, Value));
 	}
 };
+
+template <typename T>
+struct TTypeDeserializer<TArray<T*>>
+{
+	static TArray<T*> Deserialize(UPsData* Instance, const FDataField* Field, FPsDataDeserializer* Deserializer, const TArray<T*>& Value)
+	{
+		TArray<T*> NewValue;
+		if (Deserializer->ReadArray())
+		{
+			TArray<UPsData*> Elements;
+			UPsDataUPsDataLibrary::TypeDeserializeElements(Instance, Field, Deserializer, nullptr, Elements, [&Value](int32 Index, const FString& Key) -> UPsData* {
+				return Value.IsValidIndex(Index) ? Value[Index] : nullptr;
+			});
+			Deserializer->PopArray();
+
+			NewValue.Reserve(Elements.Num());
+			for (const auto Element : Elements)
+			{
+				NewValue.Add(static_cast<T*>(Element));
+			}
+		}
+		else
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s::%s\" as \"%s\""), *Instance->GetClass()->GetName(), *Field->Name, *FType<TArray<T*>>::Type())
+		}
+
+		return NewValue;
+	}
+};
+
+template <typename T>
+struct TTypeDeserializer<TMap<FString, T*>>
+{
+	static TMap<FString, T*> Deserialize(UPsData* Instance, const FDataField* Field, FPsDataDeserializer* Deserializer, const TMap<FString, T*>& Value)
+	{
+		TMap<FString, T*> NewValue;
+		if (Deserializer->ReadObject())
+		{
+			TArray<FString> Keys;
+			TArray<UPsData*> Elements;
+			UPsDataUPsDataLibrary::TypeDeserializeElements(Instance, Field, Deserializer, &Keys, Elements, [&Value](int32 Index, const FString& Key) -> UPsData* {
+				const auto Find = Value.Find(Key);
+				return Find ? *Find : nullptr;
+			});
+			Deserializer->PopObject();
+
+			NewValue.Reserve(Elements.Num());
+			for (int32 i = 0; i < Elements.Num(); ++i)
+			{
+				NewValue.Add(Keys[i], static_cast<T*>(Elements[i]));
+			}
+		}
+		else
+		{
+			UE_LOG(LogData, Warning, TEXT("Can't deserialize \"%s::%s\" as \"%s\""), *Instance->GetClass()->GetName(), *Field->Name, *FType<TMap<FString, T*>>::Type())
+		}
+		return NewValue;
+	}
+};
 } // namespace PsDataTools
@@ -96,4 +96,14 @@ struct TTypeDeserializer<bool> : public TTypeDeserializerExtended<bool, UPsDataB
 {
 };
 
+template <>
+struct TTypeSerializer<TArray<bool>> : public TTypeBulkArraySerializer<bool>
+{
+};
+
+template <>
+struct TTypeDeserializer<TArray<bool>> : public TTypeBulkArrayDeserializer<bool>
+{
+};
+
 } // namespace PsDataTools
@@ -94,4 +94,14 @@ struct TTypeDeserializer<float> : public TTypeDeserializerExtended<float, UPsDat
 {
 };
 
+template <>
+struct TTypeSerializer<TArray<float>> : public TTypeBulkArraySerializer<float>
+{
+};
+
+template <>
+struct TTypeDeserializer<TArray<float>> : public TTypeBulkArrayDeserializer<float>
+{
+};
+
 } // namespace PsDataTools
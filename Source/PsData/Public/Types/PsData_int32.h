@@ -96,4 +96,14 @@ struct TTypeDeserializer<int32> : public TTypeDeserializerExtended<int32, UPsDat
 {
 };
 
+template <>
+struct TTypeSerializer<TArray<int32>> : public TTypeBulkArraySerializer<int32>
+{
+};
+
+template <>
+struct TTypeDeserializer<TArray<int32>> : public TTypeBulkArrayDeserializer<int32>
+{
+};
+
 } // namespace PsDataTools
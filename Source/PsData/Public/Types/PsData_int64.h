@@ -96,4 +96,14 @@ struct TTypeDeserializer<int64> : public TTypeDeserializerExtended<int64, UPsDat
 {
 };
 
+template <>
+struct TTypeSerializer<TArray<int64>> : public TTypeBulkArraySerializer<int64>
+{
+};
+
+template <>
+struct TTypeDeserializer<TArray<int64>> : public TTypeBulkArrayDeserializer<int64>
+{
+};
+
 } // namespace PsDataTools
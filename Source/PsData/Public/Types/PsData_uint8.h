@@ -96,4 +96,14 @@ struct TTypeDeserializer<uint8> : public TTypeDeserializerExtended<uint8, UPsDat
 {
 };
 
+template <>
+struct TTypeSerializer<TArray<uint8>> : public TTypeBulkArraySerializer<uint8>
+{
+};
+
+template <>
+struct TTypeDeserializer<TArray<uint8>> : public TTypeBulkArrayDeserializer<uint8>
+{
+};
+
 } // namespace PsDataTools
@@ -8,7 +8,94 @@
 #include "EditorFramework/AssetImportData.h"
 #include "Engine/DataTable.h"
 #include "Misc/FileHelper.h"
+#include "Misc/ScopedSlowTask.h"
 #include "Serialization/JsonSerializer.h"
+#include "UObject/MetaData.h"
+#include "UObject/Package.h"
+
+/***********************************
+ * Utils
+ ***********************************/
+
+namespace PsDataTools
+{
+static const TCHAR* RowStructMetaKey = TEXT("PsDataRowStruct");
+static const TCHAR* RowHashesMetaKey = TEXT("PsDataRowHashes");
+static const TCHAR* RowSchemaMetaKey = TEXT("PsDataRowSchema");
+
+/** Hash of the property names, types, offsets and default values of the row struct */
+FString GetRowSchemaHash(const UScriptStruct* Struct)
+{
+	uint8* Defaults = static_cast<uint8*>(FMemory::Malloc(Struct->GetStructureSize(), Struct->GetMinAlignment()));
+	Struct->InitializeStruct(Defaults);
+
+	uint32 Hash = FCrc::TypeCrc32(Struct->GetStructureSize());
+	for (TFieldIterator<FProperty> It(Struct); It; ++It)
+	{
+		FString DefaultValue;
+		It->ExportTextItem(DefaultValue, It->ContainerPtrToValuePtr<uint8>(Defaults), nullptr, nullptr, PPF_None);
+
+		const FString Entry = FString::Printf(TEXT("%s:%s:%d:%s"), *It->GetName(), *It->GetCPPType(), It->GetOffset_ForInternal(), *DefaultValue);
+		Hash = FCrc::StrCrc32(*Entry, Hash);
+	}
+
+	Struct->DestroyStruct(Defaults);
+	FMemory::Free(Defaults);
+
+	return FString::Printf(TEXT("%08x"), Hash);
+}
+
+/**
+ * Row hashes of the previous import are kept in the package meta data as "Name,Hash" lines.
+ * All rows are rebuilt if the row struct or its layout and defaults changed since then.
+ */
+TMap<FName, uint32> LoadRowHashes(UDataTable* DataTable)
+{
+	TMap<FName, uint32> RowHashes;
+
+	UMetaData* MetaData = DataTable->GetOutermost()->GetMetaData();
+	if (!MetaData->HasValue(DataTable, RowStructMetaKey) || MetaData->GetValue(DataTable, RowStructMetaKey) != DataTable->RowStruct->GetPathName())
+	{
+		return RowHashes;
+	}
+
+	if (!MetaData->HasValue(DataTable, RowSchemaMetaKey) || MetaData->GetValue(DataTable, RowSchemaMetaKey) != GetRowSchemaHash(DataTable->RowStruct))
+	{
+		return RowHashes;
+	}
+
+	TArray<FString> Lines;
+	MetaData->GetValue(DataTable, RowHashesMetaKey).ParseIntoArrayLines(Lines);
+	RowHashes.Reserve(Lines.Num());
+	for (const auto& Line : Lines)
+	{
+		FString Name;
+		FString Hash;
+		if (Line.Split(TEXT(","), &Name, &Hash))
+		{
+			RowHashes.Add(FName(*Name), FCString::Strtoui64(*Hash, nullptr, 16));
+		}
+	}
+
+	return RowHashes;
+}
+
+void SaveRowHashes(UDataTable* DataTable, const TMap<FName, uint32>& RowHashes)
+{
+	FString Value;
+	Value.Reserve(RowHashes.Num() * 24);
+	for (const auto& Pair : RowHashes)
+	{
+		Value.Append(Pair.Key.ToString());
+		Value += FString::Printf(TEXT(",%08x\n"), Pair.Value);
+	}
+
+	UMetaData* MetaData = DataTable->GetOutermost()->GetMetaData();
+	MetaData->SetValue(DataTable, RowStructMetaKey, *DataTable->RowStruct->GetPathName());
+	MetaData->SetValue(DataTable, RowSchemaMetaKey, *GetRowSchemaHash(DataTable->RowStruct));
+	MetaData->SetValue(DataTable, RowHashesMetaKey, *Value);
+}
+} // namespace PsDataTools
 
 /***********************************
  * UPsDataDataTableImportFactory
@@ -16,21 +103,26 @@
 
 UPsDataDataTableImportFactory::UPsDataDataTableImportFactory(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, bImportCancelled(false)
+	, bImportFailed(false)
 {
 }
 
-void ImportAsJson(TArray<FString>& ImportProblems, const FString& DataToImport, UDataTable* DataTable)
+/** Returns false if the import failed or was cancelled by the user */
+bool ImportAsJson(TArray<FString>& ImportProblems, const FString& DataToImport, UDataTable* DataTable, bool& bOutCancelled)
 {
+	bOutCancelled = false;
+
 	if (DataToImport.IsEmpty())
 	{
 		ImportProblems.Add(TEXT("Input data is empty."));
-		return;
+		return false;
 	}
 
 	if (!DataTable->RowStruct)
 	{
 		ImportProblems.Add(TEXT("No RowStruct specified."));
-		return;
+		return false;
 	}
 
 	TArray<TSharedPtr<FJsonValue>> JsonArray;
@@ -38,11 +130,30 @@ void ImportAsJson(TArray<FString>& ImportProblems, const FString& DataToImport,
 	if (!FJsonSerializer::Deserialize(JsonReader, JsonArray) || JsonArray.Num() == 0)
 	{
 		ImportProblems.Add(FString::Printf(TEXT("Failed to parse the JSON data. Error: %s"), *JsonReader->GetErrorMessage()));
-		return;
+		return false;
 	}
 
-	FPsDataTableSerializer::CreateTableFromJson_Import(DataTable, JsonArray, ImportProblems);
-	DataTable->Modify(true);
+	FScopedSlowTask SlowTask(JsonArray.Num(), FText::Format(NSLOCTEXT("PsDataEditor", "ImportDataTable", "Importing {0}..."), FText::FromString(DataTable->GetName())));
+	SlowTask.MakeDialog(true);
+
+	// Only rows that differ from the previous import are rebuilt
+	TMap<FName, uint32> RowHashes = PsDataTools::LoadRowHashes(DataTable);
+
+	int32 Reported = 0;
+	const bool bImported = FPsDataTableSerializer::CreateTableFromJson_Import(DataTable, JsonArray, ImportProblems, [&SlowTask, &Reported, &bOutCancelled](int32 Processed, int32 Total) {
+		SlowTask.EnterProgressFrame(Processed - Reported);
+		Reported = Processed;
+		bOutCancelled = SlowTask.ShouldCancel();
+		return !bOutCancelled;
+	}, &RowHashes);
+
+	// Table is changed even if some rows failed, only a cancelled import leaves it untouched
+	if (!bOutCancelled)
+	{
+		PsDataTools::SaveRowHashes(DataTable, RowHashes);
+		DataTable->Modify(true);
+	}
+	return bImported;
 }
 
 #if OLD_CSV_IMPORT_FACTORY
@@ -52,7 +163,7 @@ TArray<FString> UPsDataDataTableImportFactory::DoImportDataTable(class UDataTabl
 	if (bIsJSON)
 	{
 		TArray<FString> ImportProblems;
-		ImportAsJson(ImportProblems, DataToImport, TargetDataTable);
+		bImportFailed = !ImportAsJson(ImportProblems, DataToImport, TargetDataTable, bImportCancelled);
 		return ImportProblems;
 	}
 
@@ -65,7 +176,7 @@ TArray<FString> UPsDataDataTableImportFactory::DoImportDataTable(const FCSVImpor
 	if (bIsJSON)
 	{
 		TArray<FString> ImportProblems;
-		ImportAsJson(ImportProblems, ImportSettings.DataToImport, TargetDataTable);
+		bImportFailed = !ImportAsJson(ImportProblems, ImportSettings.DataToImport, TargetDataTable, bImportCancelled);
 		return ImportProblems;
 	}
 
@@ -114,7 +225,13 @@ EReimportResult::Type UPsDataDataReimportDataTableFactory::Reimport(UObject* Obj
 	EReimportResult::Type Result = EReimportResult::Failed;
 	if (UDataTable* DataTable = Cast<UDataTable>(Obj))
 	{
-		Result = UPsDataDataTableImportFactory::ReimportCSV(DataTable) ? EReimportResult::Succeeded : EReimportResult::Failed;
+		bImportCancelled = false;
+		bImportFailed = false;
+		Result = UPsDataDataTableImportFactory::ReimportCSV(DataTable) && !bImportFailed ? EReimportResult::Succeeded : EReimportResult::Failed;
+		if (bImportCancelled)
+		{
+			Result = EReimportResult::Cancelled;
+		}
 	}
 	return Result;
 }
@@ -25,6 +25,12 @@ protected:
 #else
 	virtual TArray<FString> DoImportDataTable(const FCSVImportSettings& ImportSettings, class UDataTable* TargetDataTable) override;
 #endif
+
+	/** Set when the user cancelled the last json import */
+	bool bImportCancelled;
+
+	/** Set when the last json import couldn't be parsed or some rows failed to convert */
+	bool bImportFailed;
 };
 
 /***********************************